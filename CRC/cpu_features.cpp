@@ -0,0 +1,88 @@
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#include "cpu_features.h"
+
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+{
+#ifdef _MSC_VER
+    __cpuidex((int*)regs, (int)leaf, (int)subleaf);
+#else
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    __get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+}
+
+static uint64_t xgetbv0()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+#endif
+}
+
+static CpuFeatures detect_cpu_features()
+{
+    CpuFeatures f = {};
+    uint32_t regs[4];
+
+    cpuid(0, 0, regs);
+    const uint32_t maxLeaf = regs[0];
+    memcpy(f.m_vendor + 0, &regs[1], 4);
+    memcpy(f.m_vendor + 4, &regs[3], 4);
+    memcpy(f.m_vendor + 8, &regs[2], 4);
+    f.m_vendor[12] = '\0';
+
+    if (maxLeaf < 1)
+        return f;
+
+    cpuid(1, 0, regs);
+    const uint32_t baseFamily = (regs[0] >> 8) & 0xF;
+    const uint32_t baseModel = (regs[0] >> 4) & 0xF;
+    f.m_family = baseFamily == 0xF ? baseFamily + ((regs[0] >> 20) & 0xFF) : baseFamily;
+    f.m_model = baseFamily == 0x6 || baseFamily == 0xF ? baseModel | ((regs[0] >> 12) & 0xF0) : baseModel;
+
+    f.m_sse42 = (regs[2] >> 20) & 1;
+    f.m_pclmul = (regs[2] >> 1) & 1;
+    const bool osxsave = (regs[2] >> 27) & 1;
+    const bool avx = (regs[2] >> 28) & 1;
+
+    // XCR0: bits 1-2 are SSE/AVX state, bits 5-7 are opmask and zmm state
+    const uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+    const bool osYmm = (xcr0 & 0x06) == 0x06;
+    const bool osZmm = (xcr0 & 0xE6) == 0xE6;
+
+    if (maxLeaf >= 7)
+    {
+        cpuid(7, 0, regs);
+        f.m_avx2 = avx && osYmm && ((regs[1] >> 5) & 1);
+        f.m_avx512f = osZmm && ((regs[1] >> 16) & 1);
+        f.m_vpclmul = osZmm && ((regs[2] >> 10) & 1);
+    }
+
+    return f;
+}
+
+bool CpuFeatures::IsIntel() const
+{
+    return strcmp(m_vendor, "GenuineIntel") == 0;
+}
+
+bool CpuFeatures::IsAmd() const
+{
+    return strcmp(m_vendor, "AuthenticAMD") == 0;
+}
+
+const CpuFeatures& get_cpu_features()
+{
+    static const CpuFeatures features = detect_cpu_features();
+    return features;
+}
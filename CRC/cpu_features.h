@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+// MSVC compiles any intrinsic anywhere and leaves it to the caller to check
+// CPUID first. GCC and Clang only compile the intrinsics the target allows,
+// and building a whole file for a newer target (-msse4.2, -march=native)
+// lets them use its instructions anywhere in that file, the fallbacks and
+// the dispatch included. so every file builds for baseline x86-64, and
+// each function that uses an intrinsic past SSE2 names what it needs. its
+// callers must have checked for it.
+#if defined(__GNUC__)
+#define CRC_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CRC_TARGET(isa)
+#endif
+
+// crc32
+#define CRC_TARGET_SSE42 CRC_TARGET("sse4.2")
+
+// crc32 and pclmulqdq, and everything up to SSE4.2 (pshufb, pextrq)
+#define CRC_TARGET_CLMUL CRC_TARGET("sse4.2,pclmul")
+
+// 256-bit integer ops and gathers
+#define CRC_TARGET_AVX2 CRC_TARGET("avx2")
+
+// 512-bit vpclmulqdq, on top of the above
+#define CRC_TARGET_AVX512 CRC_TARGET("avx512f,vpclmulqdq,avx2,sse4.2,pclmul")
+
+struct CpuFeatures
+{
+    char m_vendor[13];
+    uint32_t m_family;
+    uint32_t m_model;
+
+    bool m_sse42;
+    bool m_pclmul;
+    bool m_avx2;
+    bool m_avx512f;
+    bool m_vpclmul;
+
+    bool IsIntel() const;
+    bool IsAmd() const;
+};
+
+// runs CPUID (and XGETBV, to confirm the OS saves the wider register
+// state) once, on first call
+const CpuFeatures& get_cpu_features();
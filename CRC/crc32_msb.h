@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// the MSB-first CRC-32s on the 0x04C11DB7 poly. both start from all ones;
+// BZIP2 also inverts the result. prev is a previously returned CRC.
+uint32_t crc32_mpeg2(const void* M, size_t bytes, uint32_t prev = 0xFFFFFFFFU);
+uint32_t crc32_bzip2(const void* M, size_t bytes, uint32_t prev = 0);
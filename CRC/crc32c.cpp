@@ -0,0 +1,72 @@
+#include <atomic>
+
+#include "cpu_features.h"
+#include "crc32c.h"
+
+uint32_t crc32c_tabular(const void* M, size_t bytes, uint32_t prev);
+uint32_t option_13_golden_intel(const void* M, size_t bytes, uint32_t prev);
+uint32_t option_13_golden_soft(const void* M, size_t bytes, uint32_t prev);
+uint32_t option_14_golden_amd(const void* M, size_t bytes, uint32_t prev);
+uint32_t option_15_golden_avx512(const void* M, size_t bytes, uint32_t prev);
+uint32_t option_17_golden_fusion(const void* M, size_t bytes, uint32_t prev);
+
+typedef uint32_t(*Crc32cKernel)(const void*, size_t, uint32_t);
+
+struct Crc32cChoice
+{
+    Crc32cKernel m_f;
+    const char* m_name;
+};
+
+static Crc32cChoice select_crc32c_kernel()
+{
+    const CpuFeatures& cpu = get_cpu_features();
+
+    if (!cpu.m_sse42)
+        return { crc32c_tabular, "Tabular - 16 bytes (no SSE4.2)" };
+
+    if (!cpu.m_pclmul)
+        return { option_13_golden_soft, "Golden - software clmul (no PCLMULQDQ)" };
+
+    if (cpu.m_avx512f && cpu.m_vpclmul)
+        return { option_15_golden_avx512, "Golden - AVX-512" };
+
+    // pre-Zen AMD (Jaguar, Bulldozer family) can only retire a crc32 every
+    // other cycle, so 2 streams are enough
+    if (cpu.IsAmd() && cpu.m_family < 0x17)
+        return { option_14_golden_amd, "Golden - AMD" };
+
+    // fusion needs pclmulqdq to pipeline well, which it does from Haswell
+    // and Zen onward. AVX2 is a convenient proxy for that.
+    if (cpu.m_avx2)
+        return { option_17_golden_fusion, "Golden - Fusion" };
+
+    return { option_13_golden_intel, "Golden - Intel" };
+}
+
+static const Crc32cChoice& crc32c_choice()
+{
+    static const Crc32cChoice choice = select_crc32c_kernel();
+    return choice;
+}
+
+// starts out pointing at a resolver, which rebinds it on the first call
+static uint32_t crc32c_resolve(const void* M, size_t bytes, uint32_t prev);
+static std::atomic<Crc32cKernel> g_crc32c(crc32c_resolve);
+
+static uint32_t crc32c_resolve(const void* M, size_t bytes, uint32_t prev)
+{
+    const Crc32cKernel f = crc32c_choice().m_f;
+    g_crc32c.store(f, std::memory_order_relaxed);
+    return f(M, bytes, prev);
+}
+
+uint32_t crc32c(const void* M, size_t bytes, uint32_t prev/* = 0*/)
+{
+    return g_crc32c.load(std::memory_order_relaxed)(M, bytes, prev);
+}
+
+const char* crc32c_kernel_name()
+{
+    return crc32c_choice().m_name;
+}
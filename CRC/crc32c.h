@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC32C (Castagnoli) of M, continuing from prev. the first call runs CPUID
+// and binds the fastest kernel this machine supports; later calls go
+// straight to it.
+uint32_t crc32c(const void* M, size_t bytes, uint32_t prev = 0);
+
+// human-readable name of the kernel crc32c() is bound to
+const char* crc32c_kernel_name();
+
+// the CRC of nbytes zero bytes, continuing from crc. O(log nbytes).
+uint32_t crc32c_shift(uint32_t crc, uint64_t nbytes);
+
+// the CRC of A followed by B, given crcA = crc32c(A), crcB = crc32c(B) and
+// the length of B, without touching either message. O(log lenB).
+uint32_t crc32c_combine(uint32_t crcA, uint32_t crcB, uint64_t lenB);
+
+// crc32c() split across threads (0 = one per hardware thread): the buffer
+// is cut into 1 MiB chunks, checksummed by a work-stealing pool, and the
+// chunk CRCs joined with crc32c_combine(). gives the same result as
+// crc32c().
+uint32_t crc32c_parallel(const void* M, size_t bytes, uint32_t prev = 0, uint32_t threads = 0);
+
+// crc32c() of count independent messages, written to out[0..count). the
+// messages under 1 KiB are grouped by length and run 3 at a time with their
+// crc32 chains interleaved, so they go at the crc32 port's throughput rather
+// than its latency. longer ones go through crc32c() as they are.
+void crc32c_batch(const void* const* ptrs, const size_t* lens, uint32_t* out, size_t count);
+
+// crc32c_batch(), checked against expected[]. bit i of the bitmap
+// mismatches[0..(count + 63) / 64) is set if message i's CRC differs.
+// returns the number of mismatches.
+size_t crc32c_batch_verify(const void* const* ptrs, const size_t* lens, const uint32_t* expected, uint64_t* mismatches, size_t count);
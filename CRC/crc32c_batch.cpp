@@ -0,0 +1,190 @@
+#include <cstring>
+#include <nmmintrin.h>
+
+#include "cpu_features.h"
+#include "crc32c.h"
+
+// crc32 has a latency of 3 and a throughput of 1 on everything since
+// Nehalem and Zen, so 3 independent chains are enough to keep the port
+// busy every cycle. the lockstep loop below is written out for exactly 3.
+//
+// messages are taken a block at a time and grouped by length first, so the
+// 3 messages in a group run in lockstep for nearly all of their length.
+// taking them in arrival order and swapping a new one into whichever lane
+// ran dry cost a loop exit and a refill per message, and left the other 2
+// lanes' lockstep runs cut short at random, which was slower than calling
+// crc32c() on each.
+static constexpr size_t BATCH_BLOCK = 256;
+
+// messages this long skip the lanes and go straight to crc32c(). where it
+// dispatches to the AVX-512 golden, most of their bytes are folded by
+// vpclmulqdq on another port, which beats spending crc32 slots on them;
+// elsewhere crc32c() runs its own 3 crc32 streams and it's a wash.
+static constexpr size_t BATCH_DIRECT = 1024;
+
+// the rest are binned by whole qwords, one bin per qword count
+static constexpr uint32_t BATCH_BINS = BATCH_DIRECT / 8;
+
+// a group can still straddle 2 bins that are far apart when the block is
+// sparse. a lane left with at least this much after its group's lockstep
+// runs finishes in crc32c(), which runs its own 3 streams, rather than 1
+// qword at a time.
+static constexpr size_t BATCH_LONG_TAIL = 256;
+
+namespace
+{
+    inline uint64_t load_u64(const uint8_t* p)
+    {
+        uint64_t x;
+        memcpy(&x, p, 8);
+        return x;
+    }
+
+    // the rest of one lane's message, from its CRC so far. the short case
+    // is crc32c_hardware()'s tail, kept here so it inlines: calling that
+    // instead cost about 10% on 64-256 byte packets.
+    CRC_TARGET_SSE42 inline uint32_t finish_lane(uint64_t crc, const uint8_t* M8, size_t bytes)
+    {
+        if (bytes >= BATCH_LONG_TAIL)
+            return crc32c(M8, bytes, (uint32_t)crc);
+
+        for (; bytes >= 8; bytes -= 8, M8 += 8)
+            crc = _mm_crc32_u64(crc, load_u64(M8));
+
+        // at most 7 bytes left: 4, 2 and 1 byte steps
+        uint32_t R = (uint32_t)crc;
+        if (bytes & 4)
+        {
+            uint32_t A;
+            memcpy(&A, M8, 4);
+            R = _mm_crc32_u32(R, A);
+            M8 += 4;
+        }
+        if (bytes & 2)
+        {
+            uint16_t A;
+            memcpy(&A, M8, 2);
+            R = _mm_crc32_u16(R, A);
+            M8 += 2;
+        }
+        if (bytes & 1)
+            R = _mm_crc32_u8(R, *M8);
+        return R;
+    }
+
+    inline uint32_t batch_bin(size_t bytes)
+    {
+        return (uint32_t)(bytes >> 3);
+    }
+}
+
+// 3 messages, shortest first: all 3 chains for the shortest one's whole
+// qwords, then the other 2 for the middle one's, then the longest alone
+CRC_TARGET_SSE42 static void crc32c_batch_3(const void* const* ptrs, const size_t* lens, uint32_t* out, size_t a, size_t b, size_t c)
+{
+    const uint8_t* const pA = (const uint8_t*)ptrs[a];
+    const uint8_t* const pB = (const uint8_t*)ptrs[b];
+    const uint8_t* const pC = (const uint8_t*)ptrs[c];
+    const size_t stepA = lens[a] & ~(size_t)7;
+    const size_t stepB = lens[b] & ~(size_t)7;
+
+    uint64_t crcA = 0, crcB = 0, crcC = 0;
+    size_t i = 0;
+    for (; i < stepA; i += 8)
+    {
+        crcA = _mm_crc32_u64(crcA, load_u64(pA + i));
+        crcB = _mm_crc32_u64(crcB, load_u64(pB + i));
+        crcC = _mm_crc32_u64(crcC, load_u64(pC + i));
+    }
+    out[a] = finish_lane(crcA, pA + i, lens[a] - i);
+
+    for (; i < stepB; i += 8)
+    {
+        crcB = _mm_crc32_u64(crcB, load_u64(pB + i));
+        crcC = _mm_crc32_u64(crcC, load_u64(pC + i));
+    }
+    out[b] = finish_lane(crcB, pB + i, lens[b] - i);
+    out[c] = finish_lane(crcC, pC + i, lens[c] - i);
+}
+
+static void crc32c_batch_hardware(const void* const* ptrs, const size_t* lens, uint32_t* out, size_t count)
+{
+    uint32_t order[BATCH_BLOCK];
+    for (size_t base = 0; base < count; base += BATCH_BLOCK)
+    {
+        const size_t n = count - base < BATCH_BLOCK ? count - base : BATCH_BLOCK;
+        const size_t* const blockLens = lens + base;
+
+        // counting sort of the block's short messages by bin
+        uint32_t starts[BATCH_BINS + 1] = {};
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (blockLens[i] >= BATCH_DIRECT)
+                out[base + i] = crc32c(ptrs[base + i], blockLens[i]);
+            else
+                ++starts[batch_bin(blockLens[i]) + 1];
+        }
+        for (uint32_t k = 1; k <= BATCH_BINS; ++k)
+            starts[k] += starts[k - 1];
+        for (size_t i = 0; i < n; ++i)
+            if (blockLens[i] < BATCH_DIRECT)
+                order[starts[batch_bin(blockLens[i])]++] = (uint32_t)i;
+        const size_t m = starts[BATCH_BINS];
+
+        // a group can span bins, and within a bin the last qword still
+        // differs, so each group is put in order by its real lengths
+        size_t k = 0;
+        for (; k + 3 <= m; k += 3)
+        {
+            size_t a = base + order[k], b = base + order[k + 1], c = base + order[k + 2];
+            size_t t;
+            if (lens[b] < lens[a]) { t = a; a = b; b = t; }
+            if (lens[c] < lens[b]) { t = b; b = c; c = t; }
+            if (lens[b] < lens[a]) { t = a; a = b; b = t; }
+            crc32c_batch_3(ptrs, lens, out, a, b, c);
+        }
+
+        // the last 1 or 2 messages of the batch
+        for (; k < m; ++k)
+        {
+            const size_t j = base + order[k];
+            out[j] = crc32c(ptrs[j], lens[j]);
+        }
+    }
+}
+
+void crc32c_batch(const void* const* ptrs, const size_t* lens, uint32_t* out, size_t count)
+{
+    static const bool kHasHardware = get_cpu_features().m_sse42;
+    if (!kHasHardware)
+    {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = crc32c(ptrs[i], lens[i]);
+        return;
+    }
+
+    crc32c_batch_hardware(ptrs, lens, out, count);
+}
+
+size_t crc32c_batch_verify(const void* const* ptrs, const size_t* lens, const uint32_t* expected, uint64_t* mismatches, size_t count)
+{
+    // computed a block at a time so the results stay in L1
+    constexpr size_t kBlock = 256;
+    uint32_t crcs[kBlock];
+    size_t numMismatches = 0;
+    memset(mismatches, 0, ((count + 63) / 64) * sizeof(uint64_t));
+
+    for (size_t base = 0; base < count; base += kBlock)
+    {
+        const size_t n = count - base < kBlock ? count - base : kBlock;
+        crc32c_batch(ptrs + base, lens + base, crcs, n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const uint64_t bad = crcs[i] != expected[base + i];
+            mismatches[(base + i) / 64] |= bad << ((base + i) % 64);
+            numMismatches += bad;
+        }
+    }
+
+    return numMismatches;
+}
@@ -0,0 +1,97 @@
+#include <cstdint>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+#include "crc32c.h"
+#include "crc32c_gf2.h"
+
+static constexpr uint32_t P = CRC32C_P;
+
+// x^-1 mod P: x * (P + 1) / x = P + 1 = 1 mod P, and (P + 1) / x drops
+// P's x^0 term and moves everything else down one power
+static constexpr uint32_t kXInv = (P << 1) | 1;
+
+static constexpr uint32_t xinv_pow(uint32_t n)
+{
+    uint32_t R = 0x80000000U;
+    for (uint32_t i = 0; i < n; ++i)
+        R = crc32c_mulmod(R, kXInv);
+    return R;
+}
+
+static_assert(crc32c_mulmod(kXInv, crc32c_xpow(1)) == 0x80000000U, "x^-1 mismatch");
+
+// shifting a CRC by n bytes means multiplying it by x^(8n). that's done
+// by square-and-multiply over n 4 bits at a time: table j holds
+// x^(8 * m * 16^j) for each nibble value m, so a 64-bit n takes at most 16
+// multiplies, with no data-dependent branches. the hardware multiply
+// below, clmul followed by crc32, multiplies by an extra x^33, so the
+// tables hold everything times x^-33. that makes the m = 0 entries
+// x^-33, which leaves a CRC unchanged.
+struct ShiftTable
+{
+    uint32_t m_k[16][16];
+};
+
+static constexpr ShiftTable make_shift_table()
+{
+    ShiftTable t = {};
+    const uint32_t kXInv33 = xinv_pow(33);
+    uint32_t S = crc32c_xpow(8);
+    for (uint32_t j = 0; j < 16; ++j)
+    {
+        // S = x^(8 * 16^j), and its powers
+        uint32_t Sm = 0x80000000U;
+        for (uint32_t m = 0; m < 16; ++m)
+        {
+            t.m_k[j][m] = crc32c_mulmod(Sm, kXInv33);
+            Sm = crc32c_mulmod(Sm, S);
+        }
+        S = Sm;
+    }
+    return t;
+}
+
+static constexpr ShiftTable g_shift = make_shift_table();
+
+static_assert(g_shift.m_k[0][8] == crc32c_xpow(64 - 33), "shift table mismatch");
+static_assert(g_shift.m_k[1][1] == crc32c_xpow(128 - 33), "shift table mismatch");
+
+// a * b * x^33 mod P
+CRC_TARGET_CLMUL static inline uint32_t mulmod_hw(uint32_t a, uint32_t b)
+{
+    const __m128i vP = _mm_clmulepi64_si128(_mm_cvtsi32_si128(a), _mm_cvtsi32_si128(b), 0x00);
+    return (uint32_t)_mm_crc32_u64(0, (uint64_t)_mm_cvtsi128_si64(vP));
+}
+
+CRC_TARGET_CLMUL static uint32_t crc32c_shift_hw(uint32_t crc, uint64_t nbytes)
+{
+    for (uint32_t j = 0; nbytes; ++j, nbytes >>= 4)
+        crc = mulmod_hw(crc, g_shift.m_k[j][nbytes & 15]);
+
+    return crc;
+}
+
+// without the hardware, the x^33 is multiplied back in separately
+static constexpr uint32_t kX33 = crc32c_xpow(33);
+
+static uint32_t crc32c_shift_sw(uint32_t crc, uint64_t nbytes)
+{
+    for (uint32_t j = 0; nbytes; ++j, nbytes >>= 4)
+    {
+        if (nbytes & 15)
+            crc = crc32c_mulmod(crc32c_mulmod(crc, g_shift.m_k[j][nbytes & 15]), kX33);
+    }
+    return crc;
+}
+
+uint32_t crc32c_shift(uint32_t crc, uint64_t nbytes)
+{
+    static const bool kHasHardware = get_cpu_features().m_sse42 && get_cpu_features().m_pclmul;
+    return kHasHardware ? crc32c_shift_hw(crc, nbytes) : crc32c_shift_sw(crc, nbytes);
+}
+
+uint32_t crc32c_combine(uint32_t crcA, uint32_t crcB, uint64_t lenB)
+{
+    return crc32c_shift(crcA, lenB) ^ crcB;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+#include "crc32c_gf2.h"
+
+// CRC32C of exactly N bytes. every split point and shift constant is
+// worked out at compile time, so there's no LUT, no switch on the length
+// and no alignment loop: just N / 24 qwords in each of three crc32
+// chains, one clmul merge and a fixed tail. needs SSE4.2 and PCLMULQDQ,
+// and so does everything here down to the unrolling, so that each step
+// can be inlined into the step before it.
+
+// below this, a single crc32 chain beats splitting into three and merging
+static constexpr size_t FIXED_MIN_STREAMS = 192;
+
+// stream bodies up to this many qwords are unrolled completely; longer
+// ones are unrolled 8 qwords at a time, to keep the code out of the
+// way of the I-cache
+static constexpr size_t FIXED_MAX_UNROLL = 64;
+
+template <size_t Count>
+struct FixedUnroll
+{
+    template <class F>
+    CRC_TARGET_CLMUL static inline void Run(size_t base, F& f)
+    {
+        FixedUnroll<Count - 1>::Run(base, f);
+        f(base + Count - 1);
+    }
+};
+
+template <>
+struct FixedUnroll<0>
+{
+    template <class F>
+    CRC_TARGET_CLMUL static inline void Run(size_t, F&)
+    {
+    }
+};
+
+template <size_t Count, bool Full = (Count <= FIXED_MAX_UNROLL)>
+struct FixedSteps
+{
+    template <class F>
+    CRC_TARGET_CLMUL static inline void Run(F& f)
+    {
+        FixedUnroll<Count>::Run(0, f);
+    }
+};
+
+template <size_t Count>
+struct FixedSteps<Count, false>
+{
+    template <class F>
+    CRC_TARGET_CLMUL static inline void Run(F& f)
+    {
+        for (size_t i = 0; i < Count / 8 * 8; i += 8)
+            FixedUnroll<8>::Run(i, f);
+        FixedUnroll<Count % 8>::Run(Count / 8 * 8, f);
+    }
+};
+
+static inline uint64_t fixed_load_u64(const uint8_t* p)
+{
+    uint64_t x;
+    memcpy(&x, p, 8);
+    return x;
+}
+
+// the three-stream waterfall over the first 24 * Qwords bytes: streams
+// A, B and C each take Qwords qwords. A and B are shifted past the rest
+// by clmul and folded into C's last qword, which crc32 then consumes,
+// exactly like the golden merge but with the constants known up front.
+template <size_t Qwords>
+struct FixedStreams
+{
+    CRC_TARGET_CLMUL static inline uint64_t Run(const uint8_t* M8, uint64_t R)
+    {
+        const uint8_t* pA = M8;
+        const uint8_t* pB = M8 + 8 * Qwords;
+        const uint8_t* pC = M8 + 16 * Qwords;
+
+        uint64_t crcA = R;
+        uint64_t crcB = 0;
+        uint64_t crcC = 0;
+        auto step = [&](size_t i) CRC_TARGET_CLMUL
+        {
+            crcA = _mm_crc32_u64(crcA, fixed_load_u64(pA + 8 * i));
+            crcB = _mm_crc32_u64(crcB, fixed_load_u64(pB + 8 * i));
+            crcC = _mm_crc32_u64(crcC, fixed_load_u64(pC + 8 * i));
+        };
+        FixedSteps<Qwords - 1>::Run(step);
+        crcA = _mm_crc32_u64(crcA, fixed_load_u64(pA + 8 * (Qwords - 1)));
+        crcB = _mm_crc32_u64(crcB, fixed_load_u64(pB + 8 * (Qwords - 1)));
+
+        // shifting by n bits through clmul + crc32 takes x^(n - 33)
+        constexpr uint32_t kA = crc32c_xpow(128 * Qwords - 33);
+        constexpr uint32_t kB = crc32c_xpow(64 * Qwords - 33);
+        const __m128i vA = _mm_clmulepi64_si128(_mm_cvtsi64_si128(crcA), _mm_cvtsi32_si128((int)kA), 0x00);
+        const __m128i vB = _mm_clmulepi64_si128(_mm_cvtsi64_si128(crcB), _mm_cvtsi32_si128((int)kB), 0x00);
+        const uint64_t lastC = fixed_load_u64(pC + 8 * (Qwords - 1));
+        return _mm_crc32_u64(crcC, lastC ^ (uint64_t)_mm_cvtsi128_si64(_mm_xor_si128(vA, vB)));
+    }
+};
+
+template <>
+struct FixedStreams<0>
+{
+    static inline uint64_t Run(const uint8_t*, uint64_t R)
+    {
+        return R;
+    }
+};
+
+// a single chain for whatever the streams didn't cover
+template <size_t Bytes>
+struct FixedTail
+{
+    CRC_TARGET_CLMUL static inline uint32_t Run(const uint8_t* M8, uint64_t R)
+    {
+        auto step = [&](size_t i) CRC_TARGET_CLMUL
+        {
+            R = _mm_crc32_u64(R, fixed_load_u64(M8 + 8 * i));
+        };
+        FixedSteps<Bytes / 8>::Run(step);
+        M8 += Bytes / 8 * 8;
+
+        uint32_t R32 = (uint32_t)R;
+        if (Bytes & 4)
+        {
+            uint32_t A;
+            memcpy(&A, M8, 4);
+            R32 = _mm_crc32_u32(R32, A);
+            M8 += 4;
+        }
+        if (Bytes & 2)
+        {
+            uint16_t A;
+            memcpy(&A, M8, 2);
+            R32 = _mm_crc32_u16(R32, A);
+            M8 += 2;
+        }
+        if (Bytes & 1)
+            R32 = _mm_crc32_u8(R32, *M8);
+
+        return R32;
+    }
+};
+
+template <size_t N>
+CRC_TARGET_CLMUL uint32_t crc32c_fixed(const void* M, uint32_t prev = 0)
+{
+    constexpr size_t kQwords = N >= FIXED_MIN_STREAMS ? N / 24 : 0;
+    const uint8_t* M8 = (const uint8_t*)M;
+    const uint64_t R = FixedStreams<kQwords>::Run(M8, prev);
+    return FixedTail<N - 24 * kQwords>::Run(M8 + 24 * kQwords, R);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+
+// GF(2) arithmetic modulo a CRC poly, for generating shift and fold
+// constants, at compile time or at runtime. T is uint32_t or uint64_t,
+// the width of the CRC, and P is the poly without its x^W term.
+//
+// reflected (LSB-first) CRCs keep the same reflected form as the CRCs
+// themselves: bit W - 1 - d is the x^d term. normal (MSB-first) CRCs use
+// the _msb versions, where bit d is the x^d term.
+
+// a * b mod P, one bit of a at a time, stepping b up by x each iteration
+template <typename T>
+constexpr T gf2_mulmod(T a, T b, T P)
+{
+    constexpr uint32_t W = 8 * sizeof(T);
+    T R = 0;
+    for (uint32_t d = 0; d < W; ++d)
+    {
+        if ((a >> (W - 1 - d)) & 1)
+            R ^= b;
+        b = b & 1 ? (b >> 1) ^ P : b >> 1;
+    }
+    return R;
+}
+
+// x^n mod P by square-and-multiply, so even huge n stay cheap enough for
+// constexpr evaluation
+template <typename T>
+constexpr T gf2_xpow(uint64_t n, T P)
+{
+    constexpr uint32_t W = 8 * sizeof(T);
+    T R = (T)1 << (W - 1);
+    T S = (T)1 << (W - 2);
+    for (; n; n >>= 1)
+    {
+        if (n & 1)
+            R = gf2_mulmod(R, S, P);
+        S = gf2_mulmod(S, S, P);
+    }
+    return R;
+}
+
+// the same in normal bit order: R steps up by x for each bit of a, from
+// the highest, and picks up b wherever a has a term
+template <typename T>
+constexpr T gf2_mulmod_msb(T a, T b, T P)
+{
+    constexpr uint32_t W = 8 * sizeof(T);
+    T R = 0;
+    for (uint32_t d = W; d--; )
+    {
+        R = R >> (W - 1) ? (R << 1) ^ P : R << 1;
+        if ((a >> d) & 1)
+            R ^= b;
+    }
+    return R;
+}
+
+template <typename T>
+constexpr T gf2_xpow_msb(uint64_t n, T P)
+{
+    T R = 1;
+    T S = 2;
+    for (; n; n >>= 1)
+    {
+        if (n & 1)
+            R = gf2_mulmod_msb(R, S, P);
+        S = gf2_mulmod_msb(S, S, P);
+    }
+    return R;
+}
+
+// x^W = P - x^W = the poly's own low terms, in either order
+static_assert(gf2_xpow<uint32_t>(32, 0xedb88320U) == 0xedb88320U, "gf2_xpow mismatch");
+static_assert(gf2_xpow<uint64_t>(64, 0xc96c5795d7870f42ULL) == 0xc96c5795d7870f42ULL, "gf2_xpow mismatch");
+static_assert(gf2_xpow_msb<uint32_t>(32, 0x04c11db7U) == 0x04c11db7U, "gf2_xpow_msb mismatch");
+static_assert(gf2_xpow_msb<uint64_t>(64, 0x42f0e1eba9ea3693ULL) == 0x42f0e1eba9ea3693ULL, "gf2_xpow_msb mismatch");
+
+// the Castagnoli poly, which the crc32 instruction hardcodes, and the
+// shorthands used by the CRC32C code
+
+static constexpr uint32_t CRC32C_P = 0x82f63b78U;
+
+constexpr uint32_t crc32c_mulmod(uint32_t a, uint32_t b)
+{
+    return gf2_mulmod(a, b, CRC32C_P);
+}
+
+constexpr uint32_t crc32c_xpow(uint64_t n)
+{
+    return gf2_xpow(n, CRC32C_P);
+}
+
+static_assert(crc32c_xpow(32) == CRC32C_P, "crc32c_xpow mismatch");
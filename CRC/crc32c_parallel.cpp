@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "crc32c.h"
+
+// chunks are sized to stay well inside L2 while being checksummed, and
+// big enough that the combine step at the end costs next to nothing
+static constexpr size_t CHUNK_SIZE = 1 << 20;
+
+namespace
+{
+    // each worker owns a contiguous run of chunks and takes them from the
+    // front. once its own run is empty it steals from the other workers'
+    // runs, so a worker that gets descheduled or stalls on memory doesn't
+    // hold everyone else up.
+    //
+    // each queue gets a cache line to itself, so workers taking chunks
+    // don't contend for their neighbors' counters
+    struct alignas(64) WorkQueue
+    {
+        std::atomic<size_t> m_next;
+        size_t m_end;
+    };
+
+    // std::allocator only honours an alignas wider than max_align_t from
+    // C++17 on, and this builds as C++14 too, so the queues' storage is
+    // aligned by hand. the pointer operator new returned sits just below
+    // the aligned block.
+    template <class T>
+    struct AlignedAllocator
+    {
+        typedef T value_type;
+
+        // lets moving the vector take the storage as is
+        typedef std::true_type propagate_on_container_move_assignment;
+
+        AlignedAllocator() = default;
+
+        template <class U>
+        AlignedAllocator(const AlignedAllocator<U>&)
+        {
+        }
+
+        T* allocate(size_t n)
+        {
+            uint8_t* const raw = (uint8_t*)::operator new(n * sizeof(T) + alignof(T) + sizeof(void*));
+            const uintptr_t aligned = ((uintptr_t)(raw + sizeof(void*)) + alignof(T) - 1) & ~(uintptr_t)(alignof(T) - 1);
+            ((void**)aligned)[-1] = raw;
+            return (T*)aligned;
+        }
+
+        void deallocate(T* p, size_t)
+        {
+            ::operator delete(((void**)p)[-1]);
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&)
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&)
+    {
+        return false;
+    }
+
+    typedef std::vector<WorkQueue, AlignedAllocator<WorkQueue>> WorkQueues;
+
+    struct ParallelJob
+    {
+        const uint8_t* m_M;
+        size_t m_bytes;
+        WorkQueues m_queues;
+        std::vector<uint32_t> m_crcs;
+
+        void RunChunk(size_t i)
+        {
+            const size_t offset = i * CHUNK_SIZE;
+            m_crcs[i] = crc32c(m_M + offset, std::min(CHUNK_SIZE, m_bytes - offset));
+        }
+
+        void Work(size_t self)
+        {
+            const size_t numQueues = m_queues.size();
+            for (size_t k = 0; k < numQueues; ++k)
+            {
+                WorkQueue& q = m_queues[(self + k) % numQueues];
+                for (;;)
+                {
+                    const size_t i = q.m_next.fetch_add(1, std::memory_order_relaxed);
+                    if (i >= q.m_end)
+                        break;
+                    RunChunk(i);
+                }
+            }
+        }
+    };
+}
+
+uint32_t crc32c_parallel(const void* M, size_t bytes, uint32_t prev/* = 0*/, uint32_t threads/* = 0*/)
+{
+    if (!threads)
+        threads = std::max(1U, std::thread::hardware_concurrency());
+
+    const size_t numChunks = (bytes + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (threads == 1 || numChunks < 2)
+        return crc32c(M, bytes, prev);
+
+    threads = (uint32_t)std::min<size_t>(threads, numChunks);
+
+    ParallelJob job;
+    job.m_M = (const uint8_t*)M;
+    job.m_bytes = bytes;
+    job.m_queues = WorkQueues(threads);
+    job.m_crcs.resize(numChunks);
+    for (uint32_t t = 0; t < threads; ++t)
+    {
+        job.m_queues[t].m_next.store(numChunks * t / threads, std::memory_order_relaxed);
+        job.m_queues[t].m_end = numChunks * (t + 1) / threads;
+    }
+
+    // the calling thread is worker 0
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (uint32_t t = 1; t < threads; ++t)
+        pool.emplace_back(&ParallelJob::Work, &job, (size_t)t);
+
+    job.Work(0);
+    for (std::thread& th : pool)
+        th.join();
+
+    // stitch the chunk CRCs back together in order
+    uint32_t R = prev;
+    for (size_t i = 0; i < numChunks; ++i)
+    {
+        const size_t len = std::min(CHUNK_SIZE, bytes - i * CHUNK_SIZE);
+        R = crc32c_combine(R, job.m_crcs[i], len);
+    }
+
+    return R;
+}
@@ -0,0 +1,98 @@
+#include <cstring>
+
+#include "cpu_features.h"
+#include "crc32c.h"
+#include "crc32c_stream.h"
+
+uint32_t crc32c_hardware(const void* M, size_t bytes, uint32_t prev);
+
+// below this, the golden kernels' setup and merge cost more than they
+// save, so a straight crc32 loop (Option 12) is faster
+static constexpr size_t SMALL_UPDATE = 256;
+
+Crc32cStream::Crc32cStream() :
+    m_hasHardware(get_cpu_features().m_sse42)
+{
+    Reset();
+}
+
+void Crc32cStream::Reset()
+{
+    m_crc = 0xFFFFFFFFU;
+    m_length = 0;
+    m_tailBytes = 0;
+    memset(m_tail, 0, sizeof(m_tail));
+}
+
+void Crc32cStream::Update(const void* M, size_t bytes)
+{
+    const uint8_t* M8 = (const uint8_t*)M;
+    m_length += bytes;
+
+    // top up a held-back tail first, and run it once it reaches 8 bytes
+    if (m_tailBytes)
+    {
+        const size_t take = bytes < 8 - m_tailBytes ? bytes : 8 - m_tailBytes;
+        for (size_t i = 0; i < take; ++i)
+            m_tail[m_tailBytes + i] = M8[i];
+        m_tailBytes += (uint32_t)take;
+        M8 += take;
+        bytes -= take;
+
+        if (m_tailBytes < 8)
+            return;
+
+        m_crc = m_hasHardware ? crc32c_hardware(m_tail, 8, m_crc) : crc32c(m_tail, 8, m_crc);
+        m_tailBytes = 0;
+    }
+
+    const size_t body = bytes & ~(size_t)7;
+    if (body)
+    {
+        if (m_hasHardware && body < SMALL_UPDATE)
+            m_crc = crc32c_hardware(M8, body, m_crc);
+        else
+            m_crc = crc32c(M8, body, m_crc);
+    }
+
+    m_tailBytes = (uint32_t)(bytes - body);
+    for (uint32_t i = 0; i < m_tailBytes; ++i)
+        m_tail[i] = M8[body + i];
+}
+
+uint32_t Crc32cStream::Finalize() const
+{
+    return ~crc32c(m_tail, m_tailBytes, m_crc);
+}
+
+void Crc32cStream::Serialize(uint8_t* pOut) const
+{
+    for (uint32_t i = 0; i < 4; ++i)
+        *pOut++ = uint8_t(m_crc >> (8 * i));
+    for (uint32_t i = 0; i < 8; ++i)
+        *pOut++ = uint8_t(m_length >> (8 * i));
+    *pOut++ = uint8_t(m_tailBytes);
+    memcpy(pOut, m_tail, 7);
+}
+
+bool Crc32cStream::Deserialize(const uint8_t* pIn)
+{
+    uint32_t crc = 0;
+    for (uint32_t i = 0; i < 4; ++i)
+        crc |= (uint32_t)*pIn++ << (8 * i);
+    uint64_t length = 0;
+    for (uint32_t i = 0; i < 8; ++i)
+        length |= (uint64_t)*pIn++ << (8 * i);
+    const uint32_t tailBytes = *pIn++;
+
+    // every whole 8 bytes is folded into the CRC as soon as it's complete,
+    // so the tail is always exactly what's left over
+    if (tailBytes != (length & 7))
+        return false;
+
+    m_crc = crc;
+    m_length = length;
+    m_tailBytes = tailBytes;
+    memcpy(m_tail, pIn, 7);
+    return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// incremental CRC-32C with the standard all-ones init and final inversion,
+// for data that arrives in pieces. each Update() goes to the kernel that
+// suits its size, and the sub-8-byte remainder of each piece is held back
+// so a stream of tiny pieces still runs 8 bytes per crc32.
+class Crc32cStream
+{
+public:
+    // Serialize() writes, and Deserialize() reads, exactly this many bytes:
+    // the running CRC, the total length and the held-back tail, little-endian
+    static constexpr size_t kSerializedSize = 4 + 8 + 1 + 7;
+
+    Crc32cStream();
+
+    void Update(const void* M, size_t bytes);
+
+    // the CRC-32C of everything so far. doesn't end the stream: Update()
+    // can carry on afterward
+    uint32_t Finalize() const;
+
+    void Reset();
+
+    uint64_t Length() const { return m_length; }
+
+    void Serialize(uint8_t* pOut) const;
+
+    // false (leaving the stream untouched) if the state is malformed, e.g.
+    // its tail length isn't the total length mod 8
+    bool Deserialize(const uint8_t* pIn);
+
+private:
+    uint32_t m_crc;
+    uint64_t m_length;
+    uint8_t m_tail[8];
+    uint32_t m_tailBytes;
+    bool m_hasHardware;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-64/XZ (ECMA-182 poly, reflected) and CRC-64/NVME, with their standard
+// all-ones init and final inversion. prev is a previously returned CRC,
+// for continuing across buffers. uses the PCLMULQDQ folding kernel when
+// available and slicing-by-16 otherwise.
+uint64_t crc64_xz(const void* M, size_t bytes, uint64_t prev = 0);
+uint64_t crc64_nvme(const void* M, size_t bytes, uint64_t prev = 0);
+
+// CRC-64/ECMA-182 as specified: MSB-first, zero init, no final xor
+uint64_t crc64_ecma182(const void* M, size_t bytes, uint64_t prev = 0);
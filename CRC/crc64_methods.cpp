@@ -0,0 +1,462 @@
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+#include "crc32c_gf2.h"
+#include "crc64.h"
+#include "folding_methods.h"
+#include "msb_first_methods.h"
+
+// the same approaches as the 32-bit naive, tabular and folding methods,
+// widened to a 64-bit R register. these polys CAN be changed to any
+// desired reflected 64-bit CRC poly; all tables and constants are
+// generated from them.
+static constexpr uint64_t P_XZ = 0xc96c5795d7870f42ULL;   // ECMA-182 poly, reflected
+static constexpr uint64_t P_NVME = 0x9a6c9329ac4bc9b5ULL;
+
+// CRC-64/ECMA-182 proper is MSB-first, so it gets its own kernels below,
+// with the poly in normal bit order
+static constexpr uint64_t P_ECMA = 0x42f0e1eba9ea3693ULL;
+
+template <uint64_t Poly>
+static uint64_t crc64_naive(const void* M, size_t bytes, uint64_t prev)
+{
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint64_t R = prev;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        R ^= M8[i];
+        for (uint32_t j = 0; j < 8; ++j)
+        {
+            R = R & 1 ? (R >> 1) ^ Poly : R >> 1;
+        }
+    }
+    return R;
+}
+
+// tables built at compile time exactly like the 32-bit ones: table k holds
+// CRC(i) followed by k zero bytes
+template <uint64_t Poly, uint32_t Slices>
+struct Crc64Tables
+{
+    alignas(64) uint64_t m_tbl[256 * Slices];
+};
+
+template <uint64_t Poly, uint32_t Slices>
+constexpr Crc64Tables<Poly, Slices> make_crc64_tables()
+{
+    Crc64Tables<Poly, Slices> t = {};
+    uint32_t i = 0;
+
+    for (; i < 256; ++i)
+    {
+        uint64_t R = i;
+        for (int j = 0; j < 8; ++j)
+        {
+            R = R & 1 ? (R >> 1) ^ Poly : R >> 1;
+        }
+        t.m_tbl[i] = R;
+    }
+
+    for (; i < Slices * 256; ++i)
+    {
+        const uint64_t R = t.m_tbl[i - 256];
+        t.m_tbl[i] = (R >> 8) ^ t.m_tbl[uint8_t(R)];
+    }
+
+    return t;
+}
+
+template <uint64_t Poly, uint32_t Slices>
+struct Crc64TablesFor
+{
+    static constexpr Crc64Tables<Poly, Slices> kTables = make_crc64_tables<Poly, Slices>();
+};
+
+template <uint64_t Poly, uint32_t Slices>
+constexpr Crc64Tables<Poly, Slices> Crc64TablesFor<Poly, Slices>::kTables;
+
+#define T(k, x) tbl[(k) * 256 + uint8_t(x)]
+
+template <uint64_t Poly>
+static uint64_t crc64_tabular_8_bytes(const void* M, size_t bytes, uint64_t prev)
+{
+    const uint64_t* tbl = Crc64TablesFor<Poly, 8>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint64_t R = prev;
+    for (; bytes >= 8; bytes -= 8, M8 += 8)
+    {
+        uint64_t A;
+        memcpy(&A, M8, 8);
+        R ^= A;
+        R = T(7, R >>  0) ^ T(6, R >>  8) ^ T(5, R >> 16) ^ T(4, R >> 24) ^
+            T(3, R >> 32) ^ T(2, R >> 40) ^ T(1, R >> 48) ^ T(0, R >> 56);
+    }
+
+    for (; bytes; --bytes, ++M8)
+        R = (R >> 8) ^ tbl[(R ^ *M8) & 0xFF];
+
+    return R;
+}
+
+template <uint64_t Poly>
+static uint64_t crc64_tabular_16_bytes(const void* M, size_t bytes, uint64_t prev)
+{
+    const uint64_t* tbl = Crc64TablesFor<Poly, 16>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint64_t R = prev;
+    for (; bytes >= 16; bytes -= 16, M8 += 16)
+    {
+        uint64_t A, B;
+        memcpy(&A, M8 + 0, 8);
+        memcpy(&B, M8 + 8, 8);
+        R ^= A;
+        R = T(15, R >>  0) ^ T(14, R >>  8) ^ T(13, R >> 16) ^ T(12, R >> 24) ^
+            T(11, R >> 32) ^ T(10, R >> 40) ^ T( 9, R >> 48) ^ T( 8, R >> 56) ^
+            T( 7, B >>  0) ^ T( 6, B >>  8) ^ T( 5, B >> 16) ^ T( 4, B >> 24) ^
+            T( 3, B >> 32) ^ T( 2, B >> 40) ^ T( 1, B >> 48) ^ T( 0, B >> 56);
+    }
+
+    for (; bytes; --bytes, ++M8)
+        R = (R >> 8) ^ tbl[(R ^ *M8) & 0xFF];
+
+    return R;
+}
+
+#undef T
+
+constexpr uint64_t reverse_64(uint64_t x)
+{
+    uint64_t r = 0;
+    for (uint32_t i = 0; i < 64; ++i)
+        r |= ((x >> i) & 1) << (63 - i);
+    return r;
+}
+
+// the low 64 coefficients of mu = x^128 / P (its x^64 term is implicit),
+// by long division with the poly in normal bit order
+constexpr uint64_t barrett_mu_64_normal(uint64_t Pn)
+{
+    uint64_t rem = 0, mu = 0;
+    for (int32_t d = 128; d >= 0; --d)
+    {
+        const uint64_t carry = rem >> 63;
+        rem = (rem << 1) | (d == 128);
+        if (carry)
+        {
+            rem ^= Pn;
+            if (d < 64)
+                mu |= 1ULL << d;
+        }
+    }
+    return mu;
+}
+
+template <uint64_t Poly>
+constexpr uint64_t barrett_mu_64()
+{
+    return reverse_64(barrett_mu_64_normal(reverse_64(Poly)));
+}
+
+// fold constants for carrying a 128-bit lane forward by d bits. with a
+// 64-bit R, the low qword is multiplied by x^(d+64) and the high qword by
+// x^d, each less one for the shifted reflected clmul product.
+template <uint64_t Poly>
+struct Crc64FoldingConstants
+{
+    static constexpr uint64_t k512[2] = { gf2_xpow(512 + 64 - 1, Poly), gf2_xpow(512 - 1, Poly) };
+    static constexpr uint64_t k128[2] = { gf2_xpow(128 + 64 - 1, Poly), gf2_xpow(128 - 1, Poly) };
+    static constexpr uint64_t k64 = gf2_xpow(128 - 1, Poly);
+    static constexpr uint64_t mu = barrett_mu_64<Poly>();
+};
+
+template <uint64_t Poly> constexpr uint64_t Crc64FoldingConstants<Poly>::k512[2];
+template <uint64_t Poly> constexpr uint64_t Crc64FoldingConstants<Poly>::k128[2];
+template <uint64_t Poly> constexpr uint64_t Crc64FoldingConstants<Poly>::k64;
+template <uint64_t Poly> constexpr uint64_t Crc64FoldingConstants<Poly>::mu;
+
+template <uint64_t Poly>
+CRC_TARGET_CLMUL static uint64_t crc64_folding(const void* M, size_t bytes, uint64_t prev)
+{
+    typedef Crc64FoldingConstants<Poly> K;
+    const uint8_t* pM = (const uint8_t*)M;
+    uint64_t R = prev;
+
+    if (bytes >= 16)
+    {
+        // prev is injected by xoring it into the first 64 bits of the message
+        __m128i vX = _mm_xor_si128(_mm_loadu_si128((const __m128i*)pM), _mm_cvtsi64_si128(R));
+        pM += 16;
+        bytes -= 16;
+
+        const __m128i vK128 = _mm_loadu_si128((const __m128i*)K::k128);
+
+        if (bytes >= 48)
+        {
+            __m128i v1 = _mm_loadu_si128((const __m128i*)(pM + 0));
+            __m128i v2 = _mm_loadu_si128((const __m128i*)(pM + 16));
+            __m128i v3 = _mm_loadu_si128((const __m128i*)(pM + 32));
+            pM += 48;
+            bytes -= 48;
+
+            const __m128i vK512 = _mm_loadu_si128((const __m128i*)K::k512);
+            for (; bytes >= 64; bytes -= 64, pM += 64)
+            {
+                vX = fold_128(vX, vK512, _mm_loadu_si128((const __m128i*)(pM + 0)));
+                v1 = fold_128(v1, vK512, _mm_loadu_si128((const __m128i*)(pM + 16)));
+                v2 = fold_128(v2, vK512, _mm_loadu_si128((const __m128i*)(pM + 32)));
+                v3 = fold_128(v3, vK512, _mm_loadu_si128((const __m128i*)(pM + 48)));
+            }
+
+            vX = fold_128(vX, vK128, v1);
+            vX = fold_128(vX, vK128, v2);
+            vX = fold_128(vX, vK128, v3);
+        }
+
+        for (; bytes >= 16; bytes -= 16, pM += 16)
+            vX = fold_128(vX, vK128, _mm_loadu_si128((const __m128i*)pM));
+
+        // 128 -> 64 + 64: fold the low qword by x^128 onto the high one,
+        // leaving G = Gh * x^64 + Gl
+        const __m128i vG = _mm_xor_si128(_mm_clmulepi64_si128(vX, _mm_cvtsi64_si128(K::k64), 0x00), _mm_srli_si128(vX, 8));
+        const uint64_t Gh = _mm_cvtsi128_si64(vG);
+        const uint64_t Gl = _mm_extract_epi64(vG, 1);
+
+        // Barrett reduction: q = Gh * mu / x^64, R = Gl ^ low 64 bits of q * P
+        const __m128i vQ = _mm_clmulepi64_si128(_mm_cvtsi64_si128(Gh), _mm_cvtsi64_si128(K::mu), 0x00);
+        const uint64_t q = Gh ^ ((uint64_t)_mm_cvtsi128_si64(vQ) << 1);
+        const __m128i vQP = _mm_clmulepi64_si128(_mm_cvtsi64_si128(q), _mm_cvtsi64_si128(Poly), 0x00);
+        R = Gl ^ ((uint64_t)_mm_extract_epi64(vQP, 1) << 1) ^ ((uint64_t)_mm_cvtsi128_si64(vQP) >> 63);
+    }
+
+    const uint64_t* tbl = Crc64TablesFor<Poly, 1>::kTables.m_tbl;
+    for (; bytes; --bytes, ++pM)
+        R = (R >> 8) ^ tbl[(R ^ *pM) & 0xFF];
+
+    return R;
+}
+
+// MSB-first: the same kernels in normal bit order, with R shifting left.
+// table k holds the CRC of byte i followed by k zero bytes.
+
+template <uint64_t Poly>
+static uint64_t crc64_msb_naive(const void* M, size_t bytes, uint64_t prev)
+{
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint64_t R = prev;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        R ^= (uint64_t)M8[i] << 56;
+        for (uint32_t j = 0; j < 8; ++j)
+        {
+            R = R >> 63 ? (R << 1) ^ Poly : R << 1;
+        }
+    }
+    return R;
+}
+
+template <uint64_t Poly, uint32_t Slices>
+constexpr Crc64Tables<Poly, Slices> make_crc64_msb_tables()
+{
+    Crc64Tables<Poly, Slices> t = {};
+    uint32_t i = 0;
+
+    for (; i < 256; ++i)
+    {
+        uint64_t R = (uint64_t)i << 56;
+        for (int j = 0; j < 8; ++j)
+        {
+            R = R >> 63 ? (R << 1) ^ Poly : R << 1;
+        }
+        t.m_tbl[i] = R;
+    }
+
+    for (; i < Slices * 256; ++i)
+    {
+        const uint64_t R = t.m_tbl[i - 256];
+        t.m_tbl[i] = (R << 8) ^ t.m_tbl[R >> 56];
+    }
+
+    return t;
+}
+
+template <uint64_t Poly, uint32_t Slices>
+struct Crc64MsbTablesFor
+{
+    static constexpr Crc64Tables<Poly, Slices> kTables = make_crc64_msb_tables<Poly, Slices>();
+};
+
+template <uint64_t Poly, uint32_t Slices>
+constexpr Crc64Tables<Poly, Slices> Crc64MsbTablesFor<Poly, Slices>::kTables;
+
+#define T(k, x) tbl[(k) * 256 + uint8_t(x)]
+
+template <uint64_t Poly>
+static uint64_t crc64_msb_tabular_16_bytes(const void* M, size_t bytes, uint64_t prev)
+{
+    const uint64_t* tbl = Crc64MsbTablesFor<Poly, 16>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint64_t R = prev;
+    for (; bytes >= 16; bytes -= 16, M8 += 16)
+    {
+        R ^= load_be64(M8);
+        const uint64_t B = load_be64(M8 + 8);
+        R = T(15, R >> 56) ^ T(14, R >> 48) ^ T(13, R >> 40) ^ T(12, R >> 32) ^
+            T(11, R >> 24) ^ T(10, R >> 16) ^ T( 9, R >>  8) ^ T( 8, R >>  0) ^
+            T( 7, B >> 56) ^ T( 6, B >> 48) ^ T( 5, B >> 40) ^ T( 4, B >> 32) ^
+            T( 3, B >> 24) ^ T( 2, B >> 16) ^ T( 1, B >>  8) ^ T( 0, B >>  0);
+    }
+
+    for (; bytes; --bytes, ++M8)
+        R = (R << 8) ^ tbl[(R >> 56) ^ *M8];
+
+    return R;
+}
+
+#undef T
+
+// in normal bit order the clmul product needs no correction: the high
+// qword is carried forward by x^(d+64) and the low qword by x^d
+template <uint64_t Poly>
+struct Crc64MsbFoldingConstants
+{
+    static constexpr uint64_t k512[2] = { gf2_xpow_msb(512, Poly), gf2_xpow_msb(512 + 64, Poly) };
+    static constexpr uint64_t k128[2] = { gf2_xpow_msb(128, Poly), gf2_xpow_msb(128 + 64, Poly) };
+    static constexpr uint64_t k128Only = gf2_xpow_msb(128, Poly);
+    static constexpr uint64_t mu = barrett_mu_64_normal(Poly);
+};
+
+template <uint64_t Poly> constexpr uint64_t Crc64MsbFoldingConstants<Poly>::k512[2];
+template <uint64_t Poly> constexpr uint64_t Crc64MsbFoldingConstants<Poly>::k128[2];
+template <uint64_t Poly> constexpr uint64_t Crc64MsbFoldingConstants<Poly>::k128Only;
+template <uint64_t Poly> constexpr uint64_t Crc64MsbFoldingConstants<Poly>::mu;
+
+template <uint64_t Poly>
+CRC_TARGET_CLMUL static uint64_t crc64_msb_folding(const void* M, size_t bytes, uint64_t prev)
+{
+    typedef Crc64MsbFoldingConstants<Poly> K;
+    const uint8_t* pM = (const uint8_t*)M;
+    uint64_t R = prev;
+
+    if (bytes >= 16)
+    {
+        const __m128i vReverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+        // prev is injected by xoring it into the first 64 bits of the
+        // message, which are now the high qword of the lane
+        __m128i vX = _mm_xor_si128(load_reversed(pM, vReverse), _mm_slli_si128(_mm_cvtsi64_si128(R), 8));
+        pM += 16;
+        bytes -= 16;
+
+        const __m128i vK128 = _mm_loadu_si128((const __m128i*)K::k128);
+
+        if (bytes >= 48)
+        {
+            __m128i v1 = load_reversed(pM + 0, vReverse);
+            __m128i v2 = load_reversed(pM + 16, vReverse);
+            __m128i v3 = load_reversed(pM + 32, vReverse);
+            pM += 48;
+            bytes -= 48;
+
+            const __m128i vK512 = _mm_loadu_si128((const __m128i*)K::k512);
+            for (; bytes >= 64; bytes -= 64, pM += 64)
+            {
+                vX = fold_128(vX, vK512, load_reversed(pM + 0, vReverse));
+                v1 = fold_128(v1, vK512, load_reversed(pM + 16, vReverse));
+                v2 = fold_128(v2, vK512, load_reversed(pM + 32, vReverse));
+                v3 = fold_128(v3, vK512, load_reversed(pM + 48, vReverse));
+            }
+
+            vX = fold_128(vX, vK128, v1);
+            vX = fold_128(vX, vK128, v2);
+            vX = fold_128(vX, vK128, v3);
+        }
+
+        for (; bytes >= 16; bytes -= 16, pM += 16)
+            vX = fold_128(vX, vK128, load_reversed(pM, vReverse));
+
+        // X * x^64 = hi * x^128 + lo * x^64 -> T = Th * x^64 + Tl
+        const __m128i vT = _mm_xor_si128(_mm_clmulepi64_si128(vX, _mm_cvtsi64_si128(K::k128Only), 0x01), _mm_slli_si128(vX, 8));
+        const uint64_t Th = _mm_extract_epi64(vT, 1);
+        const uint64_t Tl = _mm_cvtsi128_si64(vT);
+
+        // Barrett reduction: q = Th * mu / x^64, R = Tl ^ low 64 bits of q * P
+        const __m128i vQ = _mm_clmulepi64_si128(_mm_cvtsi64_si128(Th), _mm_cvtsi64_si128(K::mu), 0x00);
+        const uint64_t q = Th ^ (uint64_t)_mm_extract_epi64(vQ, 1);
+        R = Tl ^ (uint64_t)_mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_cvtsi64_si128(q), _mm_cvtsi64_si128(Poly), 0x00));
+    }
+
+    const uint64_t* tbl = Crc64MsbTablesFor<Poly, 1>::kTables.m_tbl;
+    for (; bytes; --bytes, ++pM)
+        R = (R << 8) ^ tbl[(R >> 56) ^ *pM];
+
+    return R;
+}
+
+// OPTION 18
+uint64_t option_18_crc64_naive(const void* M, size_t bytes)
+{
+    return crc64_naive<P_NVME>(M, bytes, 0);
+}
+
+// OPTION 19
+uint64_t option_19_crc64_tabular_8_bytes(const void* M, size_t bytes)
+{
+    return crc64_tabular_8_bytes<P_NVME>(M, bytes, 0);
+}
+
+// OPTION 20
+uint64_t option_20_crc64_tabular_16_bytes(const void* M, size_t bytes)
+{
+    return crc64_tabular_16_bytes<P_NVME>(M, bytes, 0);
+}
+
+// OPTION 21
+uint64_t option_21_crc64_folding(const void* M, size_t bytes)
+{
+    return crc64_folding<P_NVME>(M, bytes, 0);
+}
+
+uint64_t option_21_crc64_folding_xz(const void* M, size_t bytes)
+{
+    return crc64_folding<P_XZ>(M, bytes, 0);
+}
+
+uint64_t option_18_crc64_naive_ecma(const void* M, size_t bytes)
+{
+    return crc64_msb_naive<P_ECMA>(M, bytes, 0);
+}
+
+uint64_t option_20_crc64_tabular_16_bytes_ecma(const void* M, size_t bytes)
+{
+    return crc64_msb_tabular_16_bytes<P_ECMA>(M, bytes, 0);
+}
+
+uint64_t option_21_crc64_folding_ecma(const void* M, size_t bytes)
+{
+    return crc64_msb_folding<P_ECMA>(M, bytes, 0);
+}
+
+template <uint64_t Poly>
+static uint64_t crc64_inverted(const void* M, size_t bytes, uint64_t prev)
+{
+    const bool hasPclmul = get_cpu_features().m_pclmul;
+    return ~(hasPclmul ? crc64_folding<Poly>(M, bytes, ~prev) : crc64_tabular_16_bytes<Poly>(M, bytes, ~prev));
+}
+
+uint64_t crc64_xz(const void* M, size_t bytes, uint64_t prev/* = 0*/)
+{
+    return crc64_inverted<P_XZ>(M, bytes, prev);
+}
+
+uint64_t crc64_nvme(const void* M, size_t bytes, uint64_t prev/* = 0*/)
+{
+    return crc64_inverted<P_NVME>(M, bytes, prev);
+}
+
+uint64_t crc64_ecma182(const void* M, size_t bytes, uint64_t prev/* = 0*/)
+{
+    const bool hasPclmul = get_cpu_features().m_pclmul;
+    return hasPclmul ? crc64_msb_folding<P_ECMA>(M, bytes, prev) : crc64_msb_tabular_16_bytes<P_ECMA>(M, bytes, prev);
+}
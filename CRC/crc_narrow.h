@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-16/T10-DIF, CRC-16/CCITT (a.k.a. KERMIT) and CRC-8/SMBUS, all with a
+// zero init and no final xor, so prev is simply a previously returned CRC.
+// messages of 16 bytes or more take the PCLMULQDQ folding path when it is
+// available; shorter ones, and machines without it, use slicing-by-16.
+uint16_t crc16_t10dif(const void* M, size_t bytes, uint16_t prev = 0);
+uint16_t crc16_ccitt(const void* M, size_t bytes, uint16_t prev = 0);
+uint8_t crc8_smbus(const void* M, size_t bytes, uint8_t prev = 0);
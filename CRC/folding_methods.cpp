@@ -0,0 +1,143 @@
+#include <cstdint>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+#include "crc32c_gf2.h"
+#include "folding_methods.h"
+
+// unlike the hardware and golden approaches, this approach only uses
+// carry-less multiplication, so ANY reflected 32-bit poly can be used.
+// the constants below are generated from the poly at runtime.
+static constexpr uint32_t P_IEEE = 0xedb88320U;
+static constexpr uint32_t P_CASTAGNOLI = 0x82f63b78U;
+
+FoldingConstants compute_folding_constants(uint32_t P)
+{
+    FoldingConstants K;
+    // carrying a 128-bit lane forward by d bits. the low qword is
+    // multiplied by x^(d+32), the high qword by x^(d-32), each less one
+    // because the reflected clmul product comes out shifted by one bit.
+    K.k512[0] = gf2_xpow(512 + 32 - 1, P);
+    K.k512[1] = gf2_xpow(512 - 32 - 1, P);
+    K.k128[0] = gf2_xpow(128 + 32 - 1, P);
+    K.k128[1] = gf2_xpow(128 - 32 - 1, P);
+
+    // for narrowing the final 128 bits down to 64. these sit in the high
+    // dword so the products land in the high end of the result.
+    K.k96 = (uint64_t)gf2_xpow(96 - 1, P) << 32;
+    K.k64 = (uint64_t)gf2_xpow(64 - 1, P) << 32;
+
+    // Barrett constants. mu = x^64 / P, computed by long division with the
+    // poly in normal (non-reflected) bit order, then reflected into a lane.
+    uint64_t Pn = 1ULL << 32;
+    for (uint32_t i = 0; i < 32; ++i)
+        Pn |= (uint64_t)((P >> i) & 1) << (31 - i);
+
+    uint64_t rem = 0, mu = 0;
+    for (int32_t i = 64; i >= 0; --i)
+    {
+        rem = (rem << 1) | (i == 64);
+        if (rem >> 32)
+        {
+            mu |= 1ULL << i;
+            rem ^= Pn;
+        }
+    }
+
+    K.mu = 0;
+    for (uint32_t i = 0; i <= 32; ++i)
+        K.mu |= ((mu >> i) & 1) << (32 - i);
+
+    K.poly = ((uint64_t)P << 32) | (1ULL << 31);
+
+    // 1-byte tabular, for the final few bytes
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t R = i;
+        for (uint32_t j = 0; j < 8; ++j)
+        {
+            R = R & 1 ? (R >> 1) ^ P : R >> 1;
+        }
+        K.tbl[i] = R;
+    }
+    return K;
+}
+
+// the CRC of 128 bits of message data, with a zero CRC coming in
+CRC_TARGET_CLMUL static inline uint32_t reduce_128(__m128i vX, const FoldingConstants& K)
+{
+    // 128 -> 96: fold the low qword into the high 96 bits
+    __m128i vT = _mm_clmulepi64_si128(vX, _mm_cvtsi64_si128(K.k96), 0x00);
+    vT = _mm_xor_si128(vT, _mm_slli_si128(_mm_srli_si128(vX, 8), 4));
+
+    // 96 -> 64: fold the remaining 32 bits of the low qword into the high qword
+    const __m128i vA = _mm_and_si128(vT, _mm_cvtsi64_si128(0xFFFFFFFF00000000ULL));
+    vT = _mm_xor_si128(_mm_clmulepi64_si128(vA, _mm_cvtsi64_si128(K.k64), 0x00), vT);
+    const uint64_t G = _mm_extract_epi64(vT, 1);
+
+    // Barrett reduction: q = (G / x^32) * mu / x^32, R = G ^ q * P
+    const __m128i vQ = _mm_clmulepi64_si128(_mm_cvtsi64_si128(G << 32), _mm_cvtsi64_si128(K.mu), 0x00);
+    const __m128i vQP = _mm_clmulepi64_si128(vQ, _mm_cvtsi64_si128(K.poly), 0x00);
+    return (uint32_t)(G >> 32) ^ (uint32_t)(_mm_extract_epi64(vQP, 1) >> 31);
+}
+
+CRC_TARGET_CLMUL uint32_t crc32_folding(const void* M, size_t bytes, const FoldingConstants& K, uint32_t prev)
+{
+    const uint8_t* pM = (const uint8_t*)M;
+    uint32_t R = prev;
+
+    if (bytes >= 16)
+    {
+        // prev is injected by xoring it into the first 32 bits of the message
+        __m128i vX = _mm_xor_si128(_mm_loadu_si128((const __m128i*)pM), _mm_cvtsi32_si128(R));
+        pM += 16;
+        bytes -= 16;
+
+        const __m128i vK128 = _mm_loadu_si128((const __m128i*)K.k128);
+
+        if (bytes >= 48)
+        {
+            __m128i v1 = _mm_loadu_si128((const __m128i*)(pM + 0));
+            __m128i v2 = _mm_loadu_si128((const __m128i*)(pM + 16));
+            __m128i v3 = _mm_loadu_si128((const __m128i*)(pM + 32));
+            pM += 48;
+            bytes -= 48;
+
+            const __m128i vK512 = _mm_loadu_si128((const __m128i*)K.k512);
+            for (; bytes >= 64; bytes -= 64, pM += 64)
+            {
+                vX = fold_128(vX, vK512, _mm_loadu_si128((const __m128i*)(pM + 0)));
+                v1 = fold_128(v1, vK512, _mm_loadu_si128((const __m128i*)(pM + 16)));
+                v2 = fold_128(v2, vK512, _mm_loadu_si128((const __m128i*)(pM + 32)));
+                v3 = fold_128(v3, vK512, _mm_loadu_si128((const __m128i*)(pM + 48)));
+            }
+
+            vX = fold_128(vX, vK128, v1);
+            vX = fold_128(vX, vK128, v2);
+            vX = fold_128(vX, vK128, v3);
+        }
+
+        for (; bytes >= 16; bytes -= 16, pM += 16)
+            vX = fold_128(vX, vK128, _mm_loadu_si128((const __m128i*)pM));
+
+        R = reduce_128(vX, K);
+    }
+
+    for (; bytes; --bytes, ++pM)
+        R = (R >> 8) ^ K.tbl[(R ^ *pM) & 0xFF];
+
+    return R;
+}
+
+// OPTION 16
+uint32_t option_16_folding_ieee(const void* M, size_t bytes)
+{
+    static const FoldingConstants K = compute_folding_constants(P_IEEE);
+    return crc32_folding(M, bytes, K, 0);
+}
+
+uint32_t option_16_folding_castagnoli(const void* M, size_t bytes)
+{
+    static const FoldingConstants K = compute_folding_constants(P_CASTAGNOLI);
+    return crc32_folding(M, bytes, K, 0);
+}
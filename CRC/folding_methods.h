@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+
+// Option 16's constants for one reflected 32-bit poly, generated at
+// runtime by compute_folding_constants()
+struct FoldingConstants
+{
+    uint64_t k512[2];
+    uint64_t k128[2];
+    uint64_t k96;
+    uint64_t k64;
+    uint64_t mu;
+    uint64_t poly;
+    uint32_t tbl[256];
+};
+
+FoldingConstants compute_folding_constants(uint32_t P);
+uint32_t crc32_folding(const void* M, size_t bytes, const FoldingConstants& K, uint32_t prev);
+
+// one fold step, shared by every folding kernel: carries a 128-bit lane
+// forward by multiplying its low qword by vK's low qword and its high
+// qword by vK's high one, then adds the next 16 bytes. the same in either
+// bit order; only the constants differ.
+CRC_TARGET_CLMUL static inline __m128i fold_128(__m128i vX, __m128i vK, __m128i vData)
+{
+    const __m128i vLo = _mm_clmulepi64_si128(vX, vK, 0x00);
+    const __m128i vHi = _mm_clmulepi64_si128(vX, vK, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(vLo, vHi), vData);
+}
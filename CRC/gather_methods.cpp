@@ -0,0 +1,161 @@
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+#include "tabular_methods.h"
+
+// slicing-by-8 across 8 independent messages at once, one message per
+// 32-bit AVX2 lane. every table lookup is a gather, so each step does the
+// same 8 dependent lookups as Option 9 but for 8 messages. works for any
+// reflected poly; the tables are the compile-time ones from
+// tabular_methods.h.
+//
+// this is a negative result, kept for reference and not an Option. a
+// gather is still one load per lane, so the loop makes the same 1.25
+// loads per byte as Option 10 (8 table lookups plus a qword of message
+// per 8 bytes), only with the gather uops' overhead on top. it's bound by
+// load throughput, not by the latency of the dependent lookups: running a
+// second, independent set of 8 lanes alongside the first made it slower,
+// about 1.76 GB/s against 1.96 GB/s for one set, and the 8 KiB of tables
+// already sit in L1. smaller (nibble) tables would double the gathers.
+// on 64-1500 byte packets it ends up level with Option 10 one message at
+// a time, within 5-10% either way.
+static constexpr uint32_t P_IEEE = 0xedb88320U;
+
+static constexpr uint32_t GATHER_LANES = 8;
+
+template <uint32_t Poly>
+static uint32_t finish_lane(uint32_t R, const uint8_t* M8, size_t bytes)
+{
+    const uint32_t* tbl = TabularTablesFor<Poly, 1>::kTables.m_tbl;
+    for (; bytes; --bytes, ++M8)
+        R = (R >> 8) ^ tbl[(R ^ *M8) & 0xFF];
+    return R;
+}
+
+// the 8-bit field at shift s of each lane, as an index into table k
+#define IDX(v, s, k) _mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(v, s), vMask), _mm256_set1_epi32((k) * 256))
+#define LOOKUP(v, s, k) _mm256_i32gather_epi32((const int*)tbl, IDX(v, s, k), 4)
+
+template <uint32_t Poly>
+CRC_TARGET_AVX2 static void gather_batch(const void* const* ptrs, const size_t* lens, uint32_t* out, size_t count)
+{
+    const uint32_t* tbl = TabularTablesFor<Poly, 8>::kTables.m_tbl;
+    const __m256i vMask = _mm256_set1_epi32(0xFF);
+
+    // splits 4 gathered qwords per register into low and high dwords
+    const __m256i vDeinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+    const uint8_t* laneM[GATHER_LANES];
+    alignas(32) uint32_t laneCrc[GATHER_LANES];
+    size_t laneBytes[GATHER_LANES];
+    size_t laneIndex[GATHER_LANES];
+    size_t next = 0;
+
+    // fill every lane, finishing messages too short to ever enter one
+    uint32_t active = 0;
+    while (active < GATHER_LANES && next < count)
+    {
+        const size_t i = next++;
+        if (lens[i] < 8)
+        {
+            out[i] = finish_lane<Poly>(0, (const uint8_t*)ptrs[i], lens[i]);
+            continue;
+        }
+        laneM[active] = (const uint8_t*)ptrs[i];
+        laneBytes[active] = lens[i];
+        laneCrc[active] = 0;
+        laneIndex[active] = i;
+        ++active;
+    }
+
+    while (active == GATHER_LANES)
+    {
+        size_t step = laneBytes[0];
+        for (uint32_t l = 1; l < GATHER_LANES; ++l)
+            step = laneBytes[l] < step ? laneBytes[l] : step;
+        step &= ~(size_t)7;
+
+        // all 8 lanes in lockstep for as many whole qwords as the shortest
+        // one has left. the message qwords are gathered too, using each
+        // lane's pointer as the address.
+        __m256i vR = _mm256_load_si256((const __m256i*)laneCrc);
+        __m256i vAddrA = _mm256_setr_epi64x((int64_t)(uintptr_t)laneM[0], (int64_t)(uintptr_t)laneM[1], (int64_t)(uintptr_t)laneM[2], (int64_t)(uintptr_t)laneM[3]);
+        __m256i vAddrB = _mm256_setr_epi64x((int64_t)(uintptr_t)laneM[4], (int64_t)(uintptr_t)laneM[5], (int64_t)(uintptr_t)laneM[6], (int64_t)(uintptr_t)laneM[7]);
+        const __m256i vEight = _mm256_set1_epi64x(8);
+        for (size_t i = 0; i < step; i += 8)
+        {
+            const __m256i vQA = _mm256_permutevar8x32_epi32(_mm256_i64gather_epi64((const long long*)0, vAddrA, 1), vDeinterleave);
+            const __m256i vQB = _mm256_permutevar8x32_epi32(_mm256_i64gather_epi64((const long long*)0, vAddrB, 1), vDeinterleave);
+            vAddrA = _mm256_add_epi64(vAddrA, vEight);
+            vAddrB = _mm256_add_epi64(vAddrB, vEight);
+
+            vR = _mm256_xor_si256(vR, _mm256_permute2x128_si256(vQA, vQB, 0x20));
+            const __m256i vR2 = _mm256_permute2x128_si256(vQA, vQB, 0x31);
+
+            vR = _mm256_xor_si256(
+                _mm256_xor_si256(_mm256_xor_si256(LOOKUP(vR2, 24, 0), LOOKUP(vR2, 16, 1)),
+                                 _mm256_xor_si256(LOOKUP(vR2,  8, 2), LOOKUP(vR2,  0, 3))),
+                _mm256_xor_si256(_mm256_xor_si256(LOOKUP(vR,  24, 4), LOOKUP(vR,  16, 5)),
+                                 _mm256_xor_si256(LOOKUP(vR,   8, 6), LOOKUP(vR,   0, 7))));
+        }
+        _mm256_store_si256((__m256i*)laneCrc, vR);
+
+        // retire lanes that ran dry and refill them
+        for (uint32_t l = 0; l < active; ++l)
+        {
+            laneM[l] += step;
+            laneBytes[l] -= step;
+            while (laneBytes[l] < 8)
+            {
+                out[laneIndex[l]] = finish_lane<Poly>(laneCrc[l], laneM[l], laneBytes[l]);
+
+                if (next == count)
+                {
+                    // out of messages: compact the live lanes to the front.
+                    // the lane moved in hasn't been stepped yet, so it's
+                    // handled as lane l on the next pass.
+                    --active;
+                    laneM[l] = laneM[active];
+                    laneBytes[l] = laneBytes[active];
+                    laneCrc[l] = laneCrc[active];
+                    laneIndex[l] = laneIndex[active];
+                    --l;
+                    break;
+                }
+
+                const size_t i = next++;
+                laneM[l] = (const uint8_t*)ptrs[i];
+                laneBytes[l] = lens[i];
+                laneCrc[l] = 0;
+                laneIndex[l] = i;
+            }
+        }
+    }
+
+    // the last few messages, one at a time
+    for (uint32_t l = 0; l < active; ++l)
+        out[laneIndex[l]] = tabular_n_bytes<Poly, 8>(laneM[l], laneBytes[l], laneCrc[l]);
+
+    while (next < count)
+    {
+        const size_t i = next++;
+        out[i] = tabular_n_bytes<Poly, 8>(ptrs[i], lens[i]);
+    }
+}
+
+#undef LOOKUP
+#undef IDX
+
+void gather_batch_ieee(const void* const* ptrs, const size_t* lens, uint32_t* out, size_t count)
+{
+    gather_batch<P_IEEE>(ptrs, lens, out, count);
+}
+
+// the same messages through Option 10, one at a time
+void option_10_batch_ieee(const void* const* ptrs, const size_t* lens, uint32_t* out, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        out[i] = tabular_n_bytes<P_IEEE, 16>(ptrs[i], lens[i]);
+}
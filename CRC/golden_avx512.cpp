@@ -0,0 +1,94 @@
+#include <cstdint>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+#include "crc32c_gf2.h"
+
+// for this approach, the poly CANNOT be changed, because this approach
+// uses x86 hardware instructions which hardcode this poly internally. the
+// constants are all powers of x modulo CRC32C_P, from crc32c_gf2.h.
+
+uint32_t option_13_golden_intel(const void* M, size_t bytes, uint32_t prev = 0);
+
+// fold constants for carrying a 128-bit lane forward by d bits. the low
+// qword of the lane is multiplied by the first one and the high qword by
+// the second. the extra -1 in each exponent compensates for the
+// reflected clmul product coming out shifted by one bit.
+#define FOLD_K(d) crc32c_xpow((d) + 32 - 1), crc32c_xpow((d) - 32 - 1)
+
+static constexpr uint64_t g_k2048[] = { FOLD_K(2048) };
+static constexpr uint64_t g_k1536[] = { FOLD_K(1536) };
+static constexpr uint64_t g_k1024[] = { FOLD_K(1024) };
+static constexpr uint64_t g_k512[]  = { FOLD_K(512) };
+
+// per-lane constants for collapsing the 4 lanes of a zmm into the last one
+static constexpr uint64_t g_k_lanes[] = { FOLD_K(384), FOLD_K(256), FOLD_K(128), 0, 0 };
+
+#undef FOLD_K
+
+// below this, the golden waterfall wins: it has no setup cost
+static constexpr uint32_t MIN_SIZE_AVX512 = 1024;
+
+CRC_TARGET_AVX512 static inline __m512i fold_512(__m512i vX, __m512i vK, __m512i vData)
+{
+    const __m512i vLo = _mm512_clmulepi64_epi128(vX, vK, 0x00);
+    const __m512i vHi = _mm512_clmulepi64_epi128(vX, vK, 0x11);
+    return _mm512_ternarylogic_epi64(vLo, vHi, vData, 0x96);
+}
+
+// OPTION 15
+CRC_TARGET_AVX512 uint32_t option_15_golden_avx512(const void* M, size_t bytes, uint32_t prev/* = 0*/)
+{
+    if (bytes < MIN_SIZE_AVX512)
+        return option_13_golden_intel(M, bytes, prev);
+
+    const uint8_t* pM = (const uint8_t*)M;
+
+    // 4 lanes of 512 bits each. prev is injected by xoring it into the
+    // first 32 bits of the message.
+    __m512i v0 = _mm512_xor_si512(_mm512_loadu_si512(pM), _mm512_castsi128_si512(_mm_cvtsi32_si128(prev)));
+    __m512i v1 = _mm512_loadu_si512(pM + 64);
+    __m512i v2 = _mm512_loadu_si512(pM + 128);
+    __m512i v3 = _mm512_loadu_si512(pM + 192);
+    pM += 256;
+    bytes -= 256;
+
+    const __m512i vK2048 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)g_k2048));
+    while (bytes >= 256)
+    {
+        v0 = fold_512(v0, vK2048, _mm512_loadu_si512(pM));
+        v1 = fold_512(v1, vK2048, _mm512_loadu_si512(pM + 64));
+        v2 = fold_512(v2, vK2048, _mm512_loadu_si512(pM + 128));
+        v3 = fold_512(v3, vK2048, _mm512_loadu_si512(pM + 192));
+        pM += 256;
+        bytes -= 256;
+    }
+
+    const __m512i vK512 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)g_k512));
+    v3 = fold_512(v0, _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)g_k1536)), v3);
+    v3 = fold_512(v1, _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)g_k1024)), v3);
+    v3 = fold_512(v2, vK512, v3);
+
+    for (; bytes >= 64; bytes -= 64, pM += 64)
+        v3 = fold_512(v3, vK512, _mm512_loadu_si512(pM));
+
+    // fold lanes 0-2 onto lane 3. the last lane of g_k_lanes is zero, so
+    // merging lane 3 in with a mask move is the same as xoring it in.
+    const __m512i vKLanes = _mm512_loadu_si512(g_k_lanes);
+    __m512i vL = _mm512_xor_si512(_mm512_clmulepi64_epi128(v3, vKLanes, 0x00), _mm512_clmulepi64_epi128(v3, vKLanes, 0x11));
+    vL = _mm512_mask_mov_epi64(vL, 0xC0, v3);
+    const __m256i vY = _mm256_xor_si256(_mm512_castsi512_si256(vL), _mm512_extracti64x4_epi64(vL, 1));
+    const __m128i vX = _mm_xor_si128(_mm256_castsi256_si128(vY), _mm256_extracti128_si256(vY, 1));
+
+    // the remaining 128 bits are now just message data with a zero CRC
+    uint64_t crcA = _mm_crc32_u64(0, _mm_cvtsi128_si64(vX));
+    crcA = _mm_crc32_u64(crcA, _mm_extract_epi64(vX, 1));
+
+    for (; bytes >= 8; bytes -= 8, pM += 8)
+        crcA = _mm_crc32_u64(crcA, *(uint64_t*)(pM));
+
+    for (; bytes; --bytes, ++pM)
+        crcA = _mm_crc32_u8((uint32_t)crcA, *pM);
+
+    return (uint32_t)crcA;
+}
@@ -0,0 +1,105 @@
+#include <cstdint>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+#include "crc32c_gf2.h"
+#include "folding_methods.h"
+
+// for this approach, the poly CANNOT be changed, because this approach
+// uses x86 hardware instructions which hardcode this poly internally. the
+// constants are all powers of x modulo CRC32C_P, from crc32c_gf2.h.
+
+uint32_t option_13_golden_intel(const void* M, size_t bytes, uint32_t prev = 0);
+
+// the crc32 instruction and pclmulqdq execute on different ports, so each
+// block is split into a region V, folded 64 bytes at a time with pclmulqdq,
+// followed by the usual 3 crc32 streams A, B and C of FUSION_N qwords each:
+//
+//   [ V: 64 * (FUSION_ITERS + 1) bytes ][ A ][ B ][ C ]
+//
+// each loop iteration issues 3 crc32 triplets (72 bytes) alongside 1 fold
+// (64 bytes), which keeps both ports busy in roughly equal measure.
+static constexpr uint32_t FUSION_ITERS = 32;
+static constexpr uint32_t FUSION_N = 3 * FUSION_ITERS + 1;
+static constexpr uint32_t FUSION_V_BYTES = 64 * (FUSION_ITERS + 1);
+static constexpr uint32_t FUSION_BLOCK_BYTES = FUSION_V_BYTES + 24 * FUSION_N;
+
+// fold constants for carrying a 128-bit lane forward by d bits
+#define FOLD_K(d) crc32c_xpow((d) + 32 - 1), crc32c_xpow((d) - 32 - 1)
+static constexpr uint64_t g_k512[] = { FOLD_K(512) };
+static constexpr uint64_t g_k128[] = { FOLD_K(128) };
+#undef FOLD_K
+
+// shift constants for the merge, exactly as in g_lut_intel: CRC(1 << x-64)
+// for the distance from the end of each stream to the last qword of C
+static constexpr uint32_t g_kB = crc32c_xpow(31 + 64 * (FUSION_N - 1));
+static constexpr uint32_t g_kA = crc32c_xpow(31 + 64 * (2 * FUSION_N - 1));
+static constexpr uint32_t g_kV = crc32c_xpow(31 + 64 * (3 * FUSION_N - 1));
+static constexpr uint32_t g_kPrev = crc32c_xpow(31 + 64 * (3 * FUSION_N - 1) + 8 * FUSION_V_BYTES);
+
+CRC_TARGET_CLMUL static inline uint64_t clmul_k(uint64_t crc, uint32_t K)
+{
+    return _mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_cvtsi64_si128(crc), _mm_cvtsi32_si128(K), 0));
+}
+
+#define FUSION_TRIPLET(i)                               \
+crcA = _mm_crc32_u64(crcA, *(uint64_t*)(pA + 8*(i)));  \
+crcB = _mm_crc32_u64(crcB, *(uint64_t*)(pB + 8*(i)));  \
+crcC = _mm_crc32_u64(crcC, *(uint64_t*)(pC + 8*(i)));
+
+// OPTION 17
+CRC_TARGET_CLMUL uint32_t option_17_golden_fusion(const void* M, size_t bytes, uint32_t prev/* = 0*/)
+{
+    uint64_t pV = (uint64_t)M;
+    uint64_t crc = prev;
+
+    const __m128i vK512 = _mm_loadu_si128((const __m128i*)g_k512);
+    const __m128i vK128 = _mm_loadu_si128((const __m128i*)g_k128);
+
+    while (bytes >= FUSION_BLOCK_BYTES)
+    {
+        uint64_t pA = pV + FUSION_V_BYTES;
+        uint64_t pB = pA + 8 * FUSION_N;
+        uint64_t pC = pB + 8 * FUSION_N;
+        uint64_t crcA = 0, crcB = 0, crcC = 0;
+
+        // V is folded starting from a zero CRC. prev is instead shifted
+        // over the whole block in the merge, so no part of this block
+        // depends on the previous one until then.
+        __m128i v0 = _mm_loadu_si128((const __m128i*)(pV + 0));
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(pV + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(pV + 32));
+        __m128i v3 = _mm_loadu_si128((const __m128i*)(pV + 48));
+
+        for (uint32_t i = 0; i < FUSION_ITERS; ++i)
+        {
+            pV += 64;
+            FUSION_TRIPLET(0);
+            v0 = fold_128(v0, vK512, _mm_loadu_si128((const __m128i*)(pV + 0)));
+            v1 = fold_128(v1, vK512, _mm_loadu_si128((const __m128i*)(pV + 16)));
+            FUSION_TRIPLET(1);
+            v2 = fold_128(v2, vK512, _mm_loadu_si128((const __m128i*)(pV + 32)));
+            v3 = fold_128(v3, vK512, _mm_loadu_si128((const __m128i*)(pV + 48)));
+            FUSION_TRIPLET(2);
+            pA += 24;
+            pB += 24;
+            pC += 24;
+        }
+
+        v0 = fold_128(v0, vK128, v1);
+        v0 = fold_128(v0, vK128, v2);
+        v0 = fold_128(v0, vK128, v3);
+        uint64_t crcV = _mm_crc32_u64(0, _mm_cvtsi128_si64(v0));
+        crcV = _mm_crc32_u64(crcV, _mm_extract_epi64(v0, 1));
+
+        crcA = _mm_crc32_u64(crcA, *(uint64_t*)pA);
+        crcB = _mm_crc32_u64(crcB, *(uint64_t*)pB);
+        const uint64_t merged = clmul_k(crc, g_kPrev) ^ clmul_k(crcV, g_kV) ^ clmul_k(crcA, g_kA) ^ clmul_k(crcB, g_kB);
+        crc = _mm_crc32_u64(crcC, merged ^ *(uint64_t*)pC);
+
+        bytes -= FUSION_BLOCK_BYTES;
+        pV = pC + 8;
+    }
+
+    return option_13_golden_intel((const void*)pV, bytes, (uint32_t)crc);
+}
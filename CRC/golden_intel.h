@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu_features.h"
+
+// must be >= 24
+static constexpr uint32_t LEAF_SIZE_INTEL = 6 * 24;
+
+// promises a caller can make about every buffer it passes to golden_intel.
+// each one removes a loop from the kernel at compile time; debug builds
+// assert them. the length promises are about what's left after the
+// alignment prologue, so they need AlignedTo8 too.
+enum GoldenContract : uint32_t
+{
+    // M is 8-byte aligned: no byte-at-a-time prologue
+    AlignedTo8 = 1,
+
+    // bytes is a multiple of 8: no byte-at-a-time epilogue
+    LengthMultipleOf8 = 2,
+
+    // bytes is a multiple of LEAF_SIZE_INTEL: every byte goes through the
+    // three-stream loop, so there's no cleanup at all. implies LengthMultipleOf8.
+    LengthMultipleOfLeaf = 4,
+};
+
+// Option 13 with some of its edge handling compiled out. Flags is any
+// combination of GoldenContract values; golden_intel<0> is Option 13.
+// instantiated in golden_intel.cpp for 0, AlignedTo8, and AlignedTo8 with
+// either or both length promises.
+template <uint32_t Flags>
+CRC_TARGET_CLMUL uint32_t golden_intel(const void* M, size_t bytes, uint32_t prev = 0);
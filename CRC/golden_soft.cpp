@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+
+// Option 13 for CPUs with SSE4.2 but no PCLMULQDQ. the crc32 streams are
+// the same; only the merge changes, to a software carry-less multiply.
+// that costs far more than one pclmulqdq, so passes are bigger, to
+// amortize it: a larger leaf, and n capped at 1024 instead of 256, with a
+// LUT to match.
+//
+// the merge is still paid once per pass, and a record under 24 KiB is a
+// single pass whatever the leaf and cap, so neither can close the gap for
+// small records. on one AVX-512 Xeon, independent records ran about 15%
+// behind Option 13 proper at 1 KiB, 5% behind at 4 KiB, 3% at 8 KiB and
+// within 2% from 16 KiB up; on another machine the gap at 4 KiB was far
+// wider, 4.9 against 8.3 GB/s. the 8-byte hardware loop, which is what
+// crc32c() used to fall back to, was behind it from 1 KiB up on the first.
+
+// must be >= 24
+static constexpr uint32_t LEAF_SIZE_SOFT = 24 * 24;
+static constexpr uint32_t MAX_N_SOFT = 1024;
+
+void compute_golden_lut_intel(uint32_t* pTbl, uint32_t n);
+
+// pTbl[i] = x^(64i - 33). 8 KB, so it's built on first use rather than
+// compiled in
+struct GoldenSoftLut
+{
+    uint32_t m_tbl[2 * MAX_N_SOFT];
+
+    GoldenSoftLut()
+    {
+        compute_golden_lut_intel(m_tbl, MAX_N_SOFT);
+    }
+};
+
+static const GoldenSoftLut& golden_soft_lut()
+{
+    static const GoldenSoftLut lut;
+    return lut;
+}
+
+// the README's clmul(), 4 bits of a at a time: the 16 multiples of b are
+// built up front, so there are no branches and only 8 steps
+static inline uint64_t clmul_soft(uint32_t a, uint32_t b)
+{
+    uint64_t tbl[16];
+    tbl[0] = 0;
+    tbl[1] = b;
+    for (uint32_t i = 2; i < 16; i += 2)
+    {
+        tbl[i] = tbl[i >> 1] << 1;
+        tbl[i + 1] = tbl[i] ^ b;
+    }
+
+    uint64_t R = 0;
+    for (int32_t i = 28; i >= 0; i -= 4)
+        R = (R << 4) ^ tbl[(a >> i) & 15];
+    return R;
+}
+
+CRC_TARGET_SSE42 uint32_t option_13_golden_soft(const void* M, size_t bytes, uint32_t prev/* = 0*/)
+{
+    const uint32_t* lut = golden_soft_lut().m_tbl;
+    uint64_t pA = (uint64_t)M;
+    uint64_t crcA = prev;
+    uint32_t toAlign = ((uint64_t)-(int64_t)pA) & 7;
+
+    for (; toAlign && bytes; ++pA, --bytes, --toAlign)
+        crcA = _mm_crc32_u8((uint32_t)crcA, *(uint8_t*)pA);
+
+    while (bytes >= LEAF_SIZE_SOFT)
+    {
+        const uint32_t n = bytes < MAX_N_SOFT * 24 ? (uint32_t)bytes / 24 : MAX_N_SOFT;
+        uint64_t pB = pA + 8 * n;
+        uint64_t pC = pB + 8 * n;
+        uint64_t crcB = 0, crcC = 0;
+        for (const uint64_t pEnd = pB - 8; pA < pEnd; pA += 8, pB += 8, pC += 8)
+        {
+            crcA = _mm_crc32_u64(crcA, *(uint64_t*)pA);
+            crcB = _mm_crc32_u64(crcB, *(uint64_t*)pB);
+            crcC = _mm_crc32_u64(crcC, *(uint64_t*)pC);
+        }
+
+        crcA = _mm_crc32_u64(crcA, *(uint64_t*)pA);
+        crcB = _mm_crc32_u64(crcB, *(uint64_t*)pB);
+        const uint64_t K = clmul_soft((uint32_t)crcA, lut[2 * n - 1]) ^ clmul_soft((uint32_t)crcB, lut[n - 1]);
+        crcA = _mm_crc32_u64(crcC, K ^ *(uint64_t*)pC);
+
+        bytes -= 24 * n;
+        pA = pC + 8;
+    }
+
+    for (; bytes >= 8; bytes -= 8, pA += 8)
+        crcA = _mm_crc32_u64(crcA, *(uint64_t*)(pA));
+
+    for (; bytes; --bytes, ++pA)
+        crcA = _mm_crc32_u8((uint32_t)crcA, *(uint8_t*)(pA));
+
+    return (uint32_t)crcA;
+}
@@ -0,0 +1,332 @@
+// fopen and fscanf, for the tuning file
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <immintrin.h>
+#include <vector>
+
+#include "cpu_features.h"
+#include "golden_tuned.h"
+
+using namespace std::chrono;
+
+// pTbl[i] = x^(64i - 33): generated by crc32 of zeros, exactly as for
+// Options 13 and 14, just further out
+void compute_golden_lut_intel(uint32_t* pTbl, uint32_t n);
+
+namespace
+{
+    struct GoldenPlan
+    {
+        GoldenTuning m_t;
+        uint32_t(*m_f)(const void*, size_t, uint32_t, const GoldenPlan&);
+
+        // m_lut[k * n - 1] carries a stream's CRC past k following
+        // streams of n qwords
+        std::vector<uint32_t> m_lut;
+    };
+
+    // Option 13's loop for any stream count and cap. n isn't a compile-time
+    // jump target here, so instead of the switch each pass is an ordinary
+    // counted loop over all the streams in step.
+    template <uint32_t Streams>
+    CRC_TARGET_CLMUL uint32_t golden_streams(const void* M, size_t bytes, uint32_t prev, const GoldenPlan& plan)
+    {
+        static_assert(Streams >= 2 && Streams <= 5, "2 to 5 streams");
+        const uint8_t* pM = (const uint8_t*)M;
+        uint64_t crc = prev;
+
+        for (; ((uintptr_t)pM & 7) && bytes; ++pM, --bytes)
+            crc = _mm_crc32_u8((uint32_t)crc, *pM);
+
+        const uint32_t* lut = plan.m_lut.data();
+        while (bytes >= plan.m_t.m_leafSize)
+        {
+            const uint32_t n = (uint32_t)std::min<size_t>(bytes / (8 * Streams), plan.m_t.m_maxN);
+            const size_t stride = 8 * (size_t)n;
+            const uint8_t* pLast = pM + stride - 8;
+
+            // one named register per stream: compilers won't reliably keep
+            // an array of them out of memory inside the loop
+            uint64_t crc0 = crc, crc1 = 0, crc2 = 0, crc3 = 0, crc4 = 0;
+            for (const uint8_t* p = pM; p < pLast; p += 8)
+            {
+                crc0 = _mm_crc32_u64(crc0, *(const uint64_t*)(p));
+                crc1 = _mm_crc32_u64(crc1, *(const uint64_t*)(p + stride));
+                if (Streams > 2)
+                    crc2 = _mm_crc32_u64(crc2, *(const uint64_t*)(p + 2 * stride));
+                if (Streams > 3)
+                    crc3 = _mm_crc32_u64(crc3, *(const uint64_t*)(p + 3 * stride));
+                if (Streams > 4)
+                    crc4 = _mm_crc32_u64(crc4, *(const uint64_t*)(p + 4 * stride));
+            }
+            uint64_t crcs[5] = { crc0, crc1, crc2, crc3, crc4 };
+
+            // every stream but the last gets its final qword, then is
+            // shifted past the streams after it and folded into the last
+            // stream's final qword
+            __m128i vX = _mm_cvtsi64_si128(*(const uint64_t*)(pLast + (Streams - 1) * stride));
+            for (uint32_t s = 0; s < Streams - 1; ++s)
+            {
+                crcs[s] = _mm_crc32_u64(crcs[s], *(const uint64_t*)(pLast + s * stride));
+                const __m128i vK = _mm_cvtsi32_si128(lut[(Streams - 1 - s) * n - 1]);
+                vX = _mm_xor_si128(vX, _mm_clmulepi64_si128(_mm_cvtsi64_si128(crcs[s]), vK, 0));
+            }
+            crc = _mm_crc32_u64(crcs[Streams - 1], _mm_cvtsi128_si64(vX));
+
+            pM += Streams * stride;
+            bytes -= Streams * 8 * n;
+        }
+
+        for (; bytes >= 8; bytes -= 8, pM += 8)
+            crc = _mm_crc32_u64(crc, *(const uint64_t*)pM);
+
+        for (; bytes; --bytes, ++pM)
+            crc = _mm_crc32_u8((uint32_t)crc, *pM);
+
+        return (uint32_t)crc;
+    }
+
+    void make_plan(GoldenPlan* pPlan, const GoldenTuning& t)
+    {
+        static uint32_t(*const kKernels[])(const void*, size_t, uint32_t, const GoldenPlan&) = {
+            golden_streams<2>, golden_streams<3>, golden_streams<4>, golden_streams<5>,
+        };
+
+        pPlan->m_t = t;
+        pPlan->m_f = kKernels[t.m_streams - 2];
+
+        // compute_golden_lut_intel fills 2 * its n entries
+        const uint32_t entries = (t.m_streams - 1) * t.m_maxN;
+        pPlan->m_lut.resize(entries + 1);
+        compute_golden_lut_intel(pPlan->m_lut.data(), (entries + 1) / 2);
+    }
+
+    GoldenPlan& active_plan()
+    {
+        static GoldenPlan plan = [] {
+            GoldenPlan p;
+            make_plan(&p, golden_default_tuning());
+            return p;
+        }();
+        return plan;
+    }
+}
+
+GoldenTuning golden_default_tuning()
+{
+    GoldenTuning t;
+    t.m_streams = 3;
+    t.m_leafSize = 6 * 24;
+    t.m_maxN = 256;
+    return t;
+}
+
+bool golden_tuning_valid(const GoldenTuning& t)
+{
+    return t.m_streams >= 2 && t.m_streams <= 5 &&
+        t.m_leafSize >= 8 * t.m_streams &&
+        t.m_maxN >= 1 && t.m_maxN <= GOLDEN_TUNE_MAX_N;
+}
+
+// the sweep: a few sizes either side of where the leaf size matters, and a
+// few well past where the cap does. the largest stays inside L2 so the
+// crc32 throughput is what's measured, not memory.
+static constexpr uint32_t kTuneSmall[] = { 256, 1024, 4096 };
+static constexpr uint32_t kTuneLarge[] = { 16384, 65536, 262144 };
+static constexpr uint32_t kTuneSmallCount = sizeof(kTuneSmall) / sizeof(kTuneSmall[0]);
+static constexpr uint32_t kTuneLargeCount = sizeof(kTuneLarge) / sizeof(kTuneLarge[0]);
+static constexpr uint32_t kTuneBufferSize = 262144;
+
+// the finalists' rounds, and how much faster than the defaults a tuning
+// has to be to replace them
+static constexpr uint32_t kTuneRounds = 7;
+static constexpr double kTuneMargin = 0.05;
+
+// best of 5 of the average ns per byte over about 8 MB of calls
+static double time_plan(const GoldenPlan& plan, const uint8_t* M, uint32_t bytes)
+{
+    const uint32_t runs = std::max(8U, (8U << 20) / bytes);
+    double best = 1e30;
+    uint32_t sink = 0;
+    for (uint32_t rep = 0; rep < 5; ++rep)
+    {
+        auto start = steady_clock::now();
+        for (uint32_t i = 0; i < runs; ++i)
+            sink += plan.m_f(M, bytes, sink, plan);
+        auto end = steady_clock::now();
+        best = std::min(best, (double)duration_cast<nanoseconds>(end - start).count() / ((double)runs * bytes));
+    }
+
+    // keeps the calls from being dropped
+    if (sink == 0x12345678)
+        printf(" ");
+
+    return best;
+}
+
+// lower is better: the log of the geometric mean of ns per byte
+template <size_t N>
+static double score_plan(const GoldenPlan& plan, const uint8_t* M, const uint32_t (&sizes)[N])
+{
+    double score = 0;
+    for (uint32_t bytes : sizes)
+        score += std::log(time_plan(plan, M, bytes));
+    return score / N;
+}
+
+GoldenTuning golden_tune()
+{
+    std::vector<uint8_t> buffer(kTuneBufferSize);
+    uint32_t seed = 1;
+    for (uint8_t& b : buffer)
+    {
+        seed = seed * 1664525U + 1013904223U;
+        b = (uint8_t)(seed >> 24);
+    }
+    const uint8_t* M = buffer.data();
+
+    static constexpr uint32_t kCaps[] = { 64, 128, 256, 512, 1024 };
+    static constexpr uint32_t kMinN[] = { 1, 2, 4, 6, 8, 12, 16 };
+    static_assert(kCaps[sizeof(kCaps) / sizeof(kCaps[0]) - 1] <= GOLDEN_TUNE_MAX_N, "cap out of range");
+
+    // the defaults, then the best found for each stream count
+    std::vector<GoldenTuning> candidates(1, golden_default_tuning());
+    GoldenPlan plan;
+    for (uint32_t streams = 2; streams <= 5; ++streams)
+    {
+        // the cap only matters for large messages and the leaf size only
+        // for small ones, so they're chosen one after the other
+        GoldenTuning t;
+        t.m_streams = streams;
+        t.m_leafSize = 6 * 8 * streams;
+
+        double capScore = 1e30;
+        uint32_t bestCap = kCaps[0];
+        for (uint32_t cap : kCaps)
+        {
+            t.m_maxN = cap;
+            make_plan(&plan, t);
+            const double score = score_plan(plan, M, kTuneLarge);
+            if (score < capScore)
+            {
+                capScore = score;
+                bestCap = cap;
+            }
+        }
+        t.m_maxN = bestCap;
+
+        double leafScore = 1e30;
+        uint32_t bestLeaf = t.m_leafSize;
+        make_plan(&plan, t);
+        for (uint32_t minN : kMinN)
+        {
+            plan.m_t.m_leafSize = 8 * streams * minN;
+            const double score = score_plan(plan, M, kTuneSmall);
+            if (score < leafScore)
+            {
+                leafScore = score;
+                bestLeaf = plan.m_t.m_leafSize;
+            }
+        }
+        t.m_leafSize = bestLeaf;
+
+        candidates.push_back(t);
+    }
+
+    // each choice above rests on one noisy best-of-5 per setting, so the
+    // candidates are timed again on both sweeps. the rounds interleave the
+    // candidates, so a clock or cache hiccup lands on all of them alike, and
+    // each size is judged by its median over the rounds.
+    static constexpr uint32_t kSizes = kTuneSmallCount + kTuneLargeCount;
+    uint32_t sizes[kSizes];
+    std::copy(kTuneSmall, kTuneSmall + kTuneSmallCount, sizes);
+    std::copy(kTuneLarge, kTuneLarge + kTuneLargeCount, sizes + kTuneSmallCount);
+
+    const size_t numCandidates = candidates.size();
+    std::vector<GoldenPlan> plans(numCandidates);
+    for (size_t c = 0; c < numCandidates; ++c)
+        make_plan(&plans[c], candidates[c]);
+
+    std::vector<double> times(numCandidates * kSizes * kTuneRounds);
+    for (uint32_t r = 0; r < kTuneRounds; ++r)
+        for (size_t c = 0; c < numCandidates; ++c)
+            for (uint32_t s = 0; s < kSizes; ++s)
+                times[(c * kSizes + s) * kTuneRounds + r] = time_plan(plans[c], M, sizes[s]);
+
+    std::vector<double> medians(numCandidates * kSizes);
+    for (size_t i = 0; i < medians.size(); ++i)
+    {
+        double* const pT = times.data() + i * kTuneRounds;
+        std::nth_element(pT, pT + kTuneRounds / 2, pT + kTuneRounds);
+        medians[i] = pT[kTuneRounds / 2];
+    }
+
+    // a candidate must beat the defaults by kTuneMargin overall and must
+    // not lose to them by more than that at any one size. otherwise the
+    // defaults stand.
+    const double* const def = medians.data();
+    double defScore = 0;
+    for (uint32_t s = 0; s < kSizes; ++s)
+        defScore += std::log(def[s]);
+
+    GoldenTuning best = candidates[0];
+    double bestScore = defScore + kSizes * std::log(1.0 - kTuneMargin);
+    for (size_t c = 1; c < numCandidates; ++c)
+    {
+        const double* const med = medians.data() + c * kSizes;
+        double score = 0;
+        bool ok = true;
+        for (uint32_t s = 0; s < kSizes; ++s)
+        {
+            score += std::log(med[s]);
+            ok &= med[s] <= def[s] * (1.0 + kTuneMargin);
+        }
+
+        if (ok && score < bestScore)
+        {
+            bestScore = score;
+            best = candidates[c];
+        }
+    }
+
+    return best;
+}
+
+bool golden_save_tuning(const char* path, const GoldenTuning& t)
+{
+    FILE* f = fopen(path, "w");
+    if (!f)
+        return false;
+    const bool ok = fprintf(f, "streams %u leaf %u max_n %u\n", t.m_streams, t.m_leafSize, t.m_maxN) > 0;
+    return fclose(f) == 0 && ok;
+}
+
+bool golden_load_tuning(const char* path, GoldenTuning* pT)
+{
+    FILE* f = fopen(path, "r");
+    if (!f)
+        return false;
+    GoldenTuning t;
+    const bool ok = fscanf(f, "streams %u leaf %u max_n %u", &t.m_streams, &t.m_leafSize, &t.m_maxN) == 3 && golden_tuning_valid(t);
+    fclose(f);
+    if (ok)
+        *pT = t;
+    return ok;
+}
+
+void golden_apply_tuning(const GoldenTuning& t)
+{
+    if (golden_tuning_valid(t))
+        make_plan(&active_plan(), t);
+}
+
+uint32_t golden_tuned(const void* M, size_t bytes, uint32_t prev/* = 0*/)
+{
+    const GoldenPlan& plan = active_plan();
+    return plan.m_f(M, bytes, prev, plan);
+}
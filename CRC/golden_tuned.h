@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// the golden method with its hand-tuned constants (3 streams for Intel, 2
+// for AMD, LEAF_SIZE, the 256/128 cap on n) turned into parameters that
+// can be measured per machine. needs SSE4.2 and PCLMULQDQ.
+
+// the largest n (qwords per stream per pass) a tuning may use
+static constexpr uint32_t GOLDEN_TUNE_MAX_N = 1024;
+
+struct GoldenTuning
+{
+    // independent crc32 chains per pass, 2 to 5
+    uint32_t m_streams;
+
+    // below this many bytes, a single chain finishes the message.
+    // at least 8 * m_streams.
+    uint32_t m_leafSize;
+
+    // cap on qwords per stream per pass, 1 to GOLDEN_TUNE_MAX_N
+    uint32_t m_maxN;
+};
+
+// Option 13's parameters
+GoldenTuning golden_default_tuning();
+
+bool golden_tuning_valid(const GoldenTuning& t);
+
+// times every stream count with a range of caps and leaf sizes over a
+// sweep of message sizes, then times the best for each stream count again
+// alongside the defaults. returns the fastest of them only if it beats the
+// defaults by 5% overall without losing more than that at any size, else
+// the defaults. takes a second or two; meant for install time or first
+// run, with the result saved.
+GoldenTuning golden_tune();
+
+// a one-line text file. load returns false, leaving *pT untouched, if the
+// file is missing or doesn't hold a valid tuning.
+bool golden_save_tuning(const char* path, const GoldenTuning& t);
+bool golden_load_tuning(const char* path, GoldenTuning* pT);
+
+// makes golden_tuned() use t, generating its shift constants. not safe to
+// call while another thread is inside golden_tuned().
+void golden_apply_tuning(const GoldenTuning& t);
+
+// Option 13 with the applied parameters (the defaults until
+// golden_apply_tuning() is called)
+uint32_t golden_tuned(const void* M, size_t bytes, uint32_t prev = 0);
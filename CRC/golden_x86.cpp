@@ -0,0 +1,279 @@
+#include <cstdint>
+#include <cstdio>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+
+// Options 13 and 14 for 32-bit x86, where there's no 64-bit crc32: every
+// stream runs 4 bytes per crc32 instead of 8, and pointers are uintptr_t
+// rather than uint64_t. the clmul merge is unchanged except that its
+// 64-bit result goes into the last stream's final 8 bytes as two dwords.
+// each crc32 now covers 32 bits, so the LUTs are indexed by n in dwords
+// and step through x^32 per entry instead of x^64. they also build and
+// run on x64.
+
+// for this approach, the poly CANNOT be changed, because this approach
+// uses x86 hardware instructions which hardcode this poly internally.
+static constexpr uint32_t P = 0x82f63b78U;
+
+// n, in dwords per stream: the smallest the main loops can see, and the cap
+static constexpr uint32_t MIN_N_INTEL_32 = 6;
+static constexpr uint32_t MAX_N_INTEL_32 = 256;
+static constexpr uint32_t MIN_N_AMD_32 = 7;
+static constexpr uint32_t MAX_N_AMD_32 = 128;
+
+static constexpr uint32_t LEAF_SIZE_INTEL_32 = MIN_N_INTEL_32 * 12;
+static constexpr uint32_t LEAF_SIZE_AMD_32 = MIN_N_AMD_32 * 8;
+
+// n = MIN_N_INTEL_32..MAX_N_INTEL_32: x^(64n-33) in the high half (for
+// stream A) and x^(32n-33) in the low half (for stream B)
+static constexpr uint64_t g_lut_intel_32[] = {
+    0xddc0152bf20c0dfe, 0x1c291d043743f7bd, 0x9e4addf8ba4fc28e, 0x740eef02a2158b34,
+    0x39d3b2963da6d0cb, 0x083a6eec33ccbbbc, 0x0715ce53ddc0152b, 0xc49f4f676051243f,
+    0x47db83171c291d04, 0x2ad91c30a46ef4aa, 0x0d3b60929e4addf8, 0x6992cea275bba45b,
+    0xc96cfdc0740eef02, 0x7e9080481c19243b, 0x878a92a739d3b296, 0x1b3d8f296d883e38,
+    0xdaece73e083a6eec, 0xf1d0f55e1c42da43, 0xab7aff2a0715ce53, 0xa87ab8a83365346a,
+    0x2162d385c49f4f67, 0x8462d800c92f998d, 0x8334883247db8317, 0x71d111a8963e61cd,
+    0x299847d52ad91c30, 0xffd852c6169472b6, 0xb9e02b860d3b6092, 0xdcb17aa47417153f,
+    0x18b33a4e6992cea2, 0xf37c5aee6577b245, 0xb6dd949bc96cfdc0, 0x6051d5a2cf519517,
+    0x78d9ccb77e908048, 0x18b0d4ffcf23ab10, 0xbac2fd7b878a92a7, 0x21f3d99c3fc16b86,
+    0xa60ce07b1b3d8f29, 0x8f1580143207b4fe, 0xce7f39f4daece73e, 0xa00457f7c54608cd,
+    0x61d82e56f1d0f55e, 0x8d6d2c43acecf924, 0xd270f1a2ab7aff2a, 0x00ac29cf31c94608,
+    0xc619809da87ab8a8, 0xe9adf7967ccbbbf2, 0x2b3cac5d2162d385, 0x96638b3457060022,
+    0x65863b648462d800, 0xe0e9f351e6040d5a, 0x1b03397f83348832, 0x9af01f2dad327462,
+    0xebb883bd71d111a8, 0x2cff42cf0d62d3a3, 0xb3e32c28299847d5, 0x88f25a3a048dc5cc,
+    0x064f7f26ffd852c6, 0x4e36f0b0ce937661, 0xdd7e3b0cb9e02b86, 0xbd6f81f81426a815,
+    0xf285651cdcb17aa4, 0x91c9bd4be9a5d8be, 0x10746f3c18b33a4e, 0x885f087b6a921b66,
+    0xc7a68855f37c5aee, 0x4c1449325022883e, 0x271d9844b6dd949b, 0x52148f0225605e40,
+    0x8e766a0c6051d5a2, 0xa3c6f37a8f2b7ed1, 0x93a5f73078d9ccb7, 0xd7c0557fd1ca2377,
+    0x6cb08e5c18b0d4ff, 0x63ded06aab37b192, 0x6b749fb2bac2fd7b, 0x4d56973c258d3fc9,
+    0x1393e20321f3d99c, 0x9669c9df35f98786, 0xcec3662ea60ce07b, 0xe417f38afbf3ec2a,
+    0x96c515bb8f158014, 0x4b9e0f71a769f8fb, 0xe6fc4e6ace7f39f4, 0xd104b8fc87466f21,
+    0x8227bb8aa00457f7, 0x5b397730f1b1c6e4, 0xb0cd476861d82e56, 0xe78eb416bb8bd1cb,
+    0x39c7ff358d6d2c43, 0x61ff0e01f331dfab, 0xd7a4825cd270f1a2, 0x8d96551ccfb65894,
+    0x0ab3844b00ac29cf, 0x0bf80dd23dc0a1c4, 0x0167d312c619809d, 0x8821abed349f9c8e,
+    0xf6076544e9adf796, 0x6a45d2b209232f23, 0x26f6a60a2b3cac5d, 0xd8d26619f4e995fd,
+    0xa741c1bf96638b34, 0xde87806c1c498bd0, 0x98d8d9cb65863b64, 0x1433875482032e02,
+    0x49c3cc9ce0e9f351, 0x5bd2011fbed4d93f, 0x68bce87a1b03397f, 0xdd07448ecb65cf95,
+    0x57a3d0379af01f2d, 0xdde8f5b906d53151, 0x6956fc3bebb883bd, 0xa3e3e02c01eb0bf7,
+    0x42d988882cff42cf, 0xd73c7bea5055faad, 0x3771e98fb3e32c28, 0x80ff00938857e0fd,
+    0xb42ae3d988f25a3a, 0x8fe4c34ddc6b096d, 0x2178513a064f7f26, 0xdf99fc11378d7103,
+    0xe0ac139e4e36f0b0, 0x6c23e84175c7fca7, 0x170076fadd7e3b0c, 0xfe314258e986c148,
+    0x444dd413bd6f81f8, 0x0d8373a075bda454, 0x6f345e45f285651c, 0x19e3635ecd02b251,
+    0x41d17b6491c9bd4b, 0x29f268b4cc6e5462, 0xff0dba9710746f3c, 0x1dc0632a382aa4f6,
+    0xa2b73df1885f087b, 0x1614f39616547084, 0xf872e54cc7a68855, 0x9e2993d3ad1336f1,
+    0x1e41e9fc4c144932, 0x6bebd73ca624e864, 0x86d8e4d2271d9844, 0x63ae91e618de7bbf,
+    0x651bd98b52148f02, 0xf8c9da7ab9b03417, 0x5bb8f1bc8e766a0c, 0x945a19c1246144fa,
+    0xa90fd27aa3c6f37a, 0xee8213b7374e20dc, 0xb3af077a93a5f730, 0x93781dc7cf8d5f68,
+    0x4984d782d7c0557f, 0xccc4a1b9f53653f7, 0xca6ef3ac6cb08e5c, 0xa2c2d9713a6bb796,
+    0x234e0b2663ded06a, 0x1cad4452b41cbe7b, 0xdd66cbbb6b749fb2, 0x749226016d3e926f,
+    0x4597456a4d56973c, 0xc55f7eab6b1caedb, 0xe9e28eb41393e203, 0xa196232973a440c0,
+    0x7b3ff57a9669c9df, 0x2d3707499457c2de, 0xc9c8b782cec3662e, 0x397d84a14d72e542,
+    0x3f70cc6fe417f38a, 0x791132704d0b3fee, 0x93e106a496c515bb, 0xbc8178035e4f1311,
+    0x62ec6c6d4b9e0f71, 0x88eb3c07ec2c2530, 0xd813b325e6fc4e6a, 0x6e4cb63049b080e8,
+    0x0df04680d104b8fc, 0x71971d5c0783ad17, 0x2342001e8227bb8a, 0xf33b8bc6b516e7fb,
+    0x0a2a8d7e5b397730, 0x9fb3bbc01a66ff3c, 0x6d9a4957b0cd4768, 0x6ef22b234fafb81d,
+    0xe8b6368be78eb416, 0xce2df76891dc520a, 0xd2c3ed1a39c7ff35, 0xe53a4fc73fcb7290,
+    0x995a572461ff0e01, 0xbe60a91a04eb5688, 0x9ef68d35d7a4825c, 0x1dfa0a15c63764e6,
+    0x0c139b318d96551c, 0x8ec52396784d05fe, 0xf2271e600ab3844b, 0x0e766b11ceb10eba,
+    0x0b0bf8ca0bf80dd2, 0x475846a4eccc4a38, 0x2664fd8b0167d312, 0xb2a3dfa68857b79f,
+    0xed64812d8821abed, 0xdc1a160ca21a10dd, 0x02ee03b2f6076544, 0x79afdf1c62986265,
+    0x8604ae0f6a45d2b2, 0x07ac6e46081213e0, 0x363bd6b326f6a60a, 0x15f85253d9b82c5d,
+    0x135c83fdd8d26619, 0x1bec24dd70abb14f, 0x5fabe670a741c1bf, 0x4c36cd5bf0925d7f,
+    0x35ec3279de87806c, 0xe0a22e2984c7030a, 0x00bcf5f698d8d9cb, 0x7c2b6ed972e4f0b0,
+    0x8ae0068914338754, 0x06ff88fd655a2669, 0x17f2769849c3cc9c, 0xf7317cf0d5951546,
+    0x58ca5f005bd2011f, 0x61b6e40b77997415, 0xaa7c7ad568bce87a, 0xde8a97f8ca9f09ce,
+    0xb5cfca28dd07448e, 0x88f614452f8cf855, 0xded288f857a3d037, 0xd4520e9e2ee19836,
+    0x59f229bcdde8f5b9, 0x0c592bd52b6b5388, 0x6d390dec6956fc3b, 0x38edfaf361658aab,
+    0x37170390a3e3e02c, 0x72cbfcdb09e67b24, 0x6353c1cc42d98888, 0x348331a5027518a7,
+    0xc4584f5cd73c7bea, 0xc3977c1977350f62, 0xf48642e93771e98f, 0xdafaea7cc520d38c,
+    0x531377e280ff0093, 0x73db4c04f8f3eec0, 0xdd35bc8db42ae3d9, 0x72675ce8cc1ed7c4,
+    0xb25b29f28fe4c34d, 0x3ec2ff83b4d929dc, 0x9a5ede412178513a, 0xe8c7a017957f901e,
+    0xa563905ddf99fc11, 0xcf4bfaef887a7d66, 0x45cddf4ee0ac139e, 0x6bde1ac7a7afa7ea,
+    0xacfa31036c23e841, 0xae1175c2845dd03d, 0xa51b6135170076fa,
+};
+
+// n = MIN_N_AMD_32..MAX_N_AMD_32: x^(32n-33), for stream A
+static constexpr uint32_t g_lut_amd_32[] =
+{
+    0x3743f7bd, 0xba4fc28e, 0xa2158b34, 0x3da6d0cb, 0x33ccbbbc, 0xddc0152b, 0x6051243f, 0x1c291d04,
+    0xa46ef4aa, 0x9e4addf8, 0x75bba45b, 0x740eef02, 0x1c19243b, 0x39d3b296, 0x6d883e38, 0x083a6eec,
+    0x1c42da43, 0x0715ce53, 0x3365346a, 0xc49f4f67, 0xc92f998d, 0x47db8317, 0x963e61cd, 0x2ad91c30,
+    0x169472b6, 0x0d3b6092, 0x7417153f, 0x6992cea2, 0x6577b245, 0xc96cfdc0, 0xcf519517, 0x7e908048,
+    0xcf23ab10, 0x878a92a7, 0x3fc16b86, 0x1b3d8f29, 0x3207b4fe, 0xdaece73e, 0xc54608cd, 0xf1d0f55e,
+    0xacecf924, 0xab7aff2a, 0x31c94608, 0xa87ab8a8, 0x7ccbbbf2, 0x2162d385, 0x57060022, 0x8462d800,
+    0xe6040d5a, 0x83348832, 0xad327462, 0x71d111a8, 0x0d62d3a3, 0x299847d5, 0x048dc5cc, 0xffd852c6,
+    0xce937661, 0xb9e02b86, 0x1426a815, 0xdcb17aa4, 0xe9a5d8be, 0x18b33a4e, 0x6a921b66, 0xf37c5aee,
+    0x5022883e, 0xb6dd949b, 0x25605e40, 0x6051d5a2, 0x8f2b7ed1, 0x78d9ccb7, 0xd1ca2377, 0x18b0d4ff,
+    0xab37b192, 0xbac2fd7b, 0x258d3fc9, 0x21f3d99c, 0x35f98786, 0xa60ce07b, 0xfbf3ec2a, 0x8f158014,
+    0xa769f8fb, 0xce7f39f4, 0x87466f21, 0xa00457f7, 0xf1b1c6e4, 0x61d82e56, 0xbb8bd1cb, 0x8d6d2c43,
+    0xf331dfab, 0xd270f1a2, 0xcfb65894, 0x00ac29cf, 0x3dc0a1c4, 0xc619809d, 0x349f9c8e, 0xe9adf796,
+    0x09232f23, 0x2b3cac5d, 0xf4e995fd, 0x96638b34, 0x1c498bd0, 0x65863b64, 0x82032e02, 0xe0e9f351,
+    0xbed4d93f, 0x1b03397f, 0xcb65cf95, 0x9af01f2d, 0x06d53151, 0xebb883bd, 0x01eb0bf7, 0x2cff42cf,
+    0x5055faad, 0xb3e32c28, 0x8857e0fd, 0x88f25a3a, 0xdc6b096d, 0x064f7f26, 0x378d7103, 0x4e36f0b0,
+    0x75c7fca7, 0xdd7e3b0c,
+};
+
+static_assert(sizeof(g_lut_intel_32) / sizeof(g_lut_intel_32[0]) == MAX_N_INTEL_32 - MIN_N_INTEL_32 + 1, "g_lut_intel_32 must hold n = MIN_N_INTEL_32..MAX_N_INTEL_32");
+static_assert(sizeof(g_lut_amd_32) / sizeof(g_lut_amd_32[0]) == MAX_N_AMD_32 - MIN_N_AMD_32 + 1, "g_lut_amd_32 must hold n = MIN_N_AMD_32..MAX_N_AMD_32");
+
+// pTbl[i] = x^(32i + 31), by crc32 of zero dwords
+CRC_TARGET_SSE42 void compute_golden_lut_32(uint32_t* pTbl, uint32_t n)
+{
+    uint32_t R = 1;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        pTbl[i] = R;
+        R = _mm_crc32_u32(R, 0);
+    }
+}
+
+void print_golden_lut_32(uint32_t* pTbl)
+{
+    printf("static constexpr uint64_t g_lut_intel_32[] = {\n");
+    for (uint32_t n = MIN_N_INTEL_32; n <= MAX_N_INTEL_32; ++n)
+    {
+        printf("0x%08x%08x,%c", pTbl[2 * n - 2], pTbl[n - 2], ((n - MIN_N_INTEL_32) & 3) == 3 ? '\n' : ' ');
+    }
+    printf("};\n");
+
+    printf("static constexpr uint32_t g_lut_amd_32[] = {\n");
+    for (uint32_t n = MIN_N_AMD_32; n <= MAX_N_AMD_32; ++n)
+    {
+        printf("0x%08x,%c", pTbl[n - 2], ((n - MIN_N_AMD_32) & 7) == 7 ? '\n' : ' ');
+    }
+    printf("};\n");
+}
+
+void golden_lut_print_demo_32()
+{
+    constexpr uint32_t kN = 2 * MAX_N_INTEL_32;
+    uint32_t* pTbl = new uint32_t[kN];
+    compute_golden_lut_32(pTbl, kN);
+    print_golden_lut_32(pTbl);
+    delete[] pTbl;
+}
+
+#define X0(n) CRC_ITER(n);
+#define X1(n) X0(n+1) X0(n)
+#define X2(n) X1(n+2) X1(n)
+#define X3(n) X2(n+4) X2(n)
+#define X4(n) X3(n+8) X3(n)
+#define X5(n) X4(n+16) X4(n)
+#define X6(n) X5(n+32) X5(n)
+
+#define S0(n) CRC_STEP(n);
+#define S1(n) S0(n+1) S0(n)
+
+#define CRC_STEP(i)                                     \
+crcA = _mm_crc32_u32(crcA, *(uint32_t*)(pA - 4*(i)));   \
+crcB = _mm_crc32_u32(crcB, *(uint32_t*)(pB - 4*(i)));   \
+crcC = _mm_crc32_u32(crcC, *(uint32_t*)(pC - 4*(i)));
+
+#define CRC_ITER(i) case i: CRC_STEP(i)
+
+// as generated by print_golden_waterfall(256, 6), except that the steps
+// stop at 3: C's last 8 bytes go into the merge
+#define CRC_ITERS_256_TO_6() do {X0(256) X1(254) X2(250) X3(242) X4(226) X5(194) X6(130) X6(66) X5(34) X4(18) X3(10) X2(6)} while(0)
+#define CRC_STEPS_5_TO_3() do { S1(4) S0(3) } while(0)
+
+// OPTION 13, 32-bit
+CRC_TARGET_CLMUL uint32_t option_13_golden_intel_32(const void* M, size_t bytes, uint32_t prev/* = 0*/)
+{
+    uintptr_t pA = (uintptr_t)M;
+    uint32_t crcA = prev;
+    uint32_t toAlign = (uint32_t)(0 - pA) & 3;
+
+    for (; toAlign && bytes; ++pA, --bytes, --toAlign)
+        crcA = _mm_crc32_u8(crcA, *(uint8_t*)pA);
+
+    while (bytes >= LEAF_SIZE_INTEL_32)
+    {
+        const uint32_t n = bytes < MAX_N_INTEL_32 * 12 ? (uint32_t)bytes / 12 : MAX_N_INTEL_32;
+        pA += 4 * n;
+        uintptr_t pB = pA + 4 * n;
+        uintptr_t pC = pB + 4 * n;
+        uint32_t crcB = 0, crcC = 0;
+        switch (n)
+            CRC_ITERS_256_TO_6();
+        CRC_STEPS_5_TO_3();
+
+        crcA = _mm_crc32_u32(crcA, *(uint32_t*)(pA - 8));
+        crcB = _mm_crc32_u32(crcB, *(uint32_t*)(pB - 8));
+        crcA = _mm_crc32_u32(crcA, *(uint32_t*)(pA - 4));
+        crcB = _mm_crc32_u32(crcB, *(uint32_t*)(pB - 4));
+
+        const __m128i vK = _mm_cvtepu32_epi64(_mm_loadl_epi64((const __m128i*)(&g_lut_intel_32[n - MIN_N_INTEL_32])));
+        const __m128i vA = _mm_clmulepi64_si128(_mm_cvtsi32_si128(crcA), vK, 0x10);
+        const __m128i vB = _mm_clmulepi64_si128(_mm_cvtsi32_si128(crcB), vK, 0x00);
+        const __m128i vX = _mm_xor_si128(_mm_xor_si128(vA, vB), _mm_loadl_epi64((const __m128i*)(pC - 8)));
+        crcA = _mm_crc32_u32(crcC, _mm_cvtsi128_si32(vX));
+        crcA = _mm_crc32_u32(crcA, _mm_extract_epi32(vX, 1));
+
+        bytes -= 12 * n;
+        pA = pC;
+    }
+
+    for (; bytes >= 4; bytes -= 4, pA += 4)
+        crcA = _mm_crc32_u32(crcA, *(uint32_t*)(pA));
+
+    for (; bytes; --bytes, ++pA)
+        crcA = _mm_crc32_u8(crcA, *(uint8_t*)(pA));
+
+    return crcA;
+}
+
+#undef CRC_STEP
+#undef CRC_ITER
+
+#define CRC_STEP(i)                                     \
+crcA = _mm_crc32_u32(crcA, *(uint32_t*)(pA - 4*(i)));   \
+crcB = _mm_crc32_u32(crcB, *(uint32_t*)(pB - 4*(i)));
+
+#define CRC_ITER(i) case i: CRC_STEP(i)
+
+// as generated by print_golden_waterfall(128, 7), with the steps stopping
+// at 3 as above
+#define CRC_ITERS_128_TO_7() do {X0(128) X1(126) X2(122) X3(114) X4(98) X5(66) X5(34) X4(18) X3(10) X1(8) X0(7)} while(0)
+#define CRC_STEPS_6_TO_3() do { S1(5) S1(3) } while(0)
+
+// OPTION 14, 32-bit
+CRC_TARGET_CLMUL uint32_t option_14_golden_amd_32(const void* M, size_t bytes, uint32_t prev/* = 0*/)
+{
+    uintptr_t pA = (uintptr_t)M;
+    uint32_t crcA = prev;
+    uint32_t toAlign = (uint32_t)(0 - pA) & 3;
+
+    for (; toAlign && bytes; ++pA, --bytes, --toAlign)
+        crcA = _mm_crc32_u8(crcA, *(uint8_t*)pA);
+
+    while (bytes >= LEAF_SIZE_AMD_32)
+    {
+        const uint32_t n = bytes < MAX_N_AMD_32 * 8 ? (uint32_t)bytes >> 3 : MAX_N_AMD_32;
+        pA += 4 * n;
+        uintptr_t pB = pA + 4 * n;
+        uint32_t crcB = 0;
+        switch (n)
+            CRC_ITERS_128_TO_7();
+        CRC_STEPS_6_TO_3();
+
+        crcA = _mm_crc32_u32(crcA, *(uint32_t*)(pA - 8));
+        crcA = _mm_crc32_u32(crcA, *(uint32_t*)(pA - 4));
+
+        const __m128i vA = _mm_clmulepi64_si128(_mm_cvtsi32_si128(crcA), _mm_cvtsi32_si128(g_lut_amd_32[n - MIN_N_AMD_32]), 0x00);
+        const __m128i vX = _mm_xor_si128(vA, _mm_loadl_epi64((const __m128i*)(pB - 8)));
+        crcA = _mm_crc32_u32(crcB, _mm_cvtsi128_si32(vX));
+        crcA = _mm_crc32_u32(crcA, _mm_extract_epi32(vX, 1));
+
+        bytes -= 8 * n;
+        pA = pB;
+    }
+
+    for (; bytes >= 4; bytes -= 4, pA += 4)
+        crcA = _mm_crc32_u32(crcA, *(uint32_t*)(pA));
+
+    for (; bytes; --bytes, ++pA)
+        crcA = _mm_crc32_u8(crcA, *(uint8_t*)(pA));
+
+    return crcA;
+}
@@ -1,16 +1,22 @@
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <immintrin.h>
 
+#include "cpu_features.h"
+
 // for these approaches, the poly CANNOT be changed, because these approaches
 // use x86 hardware instructions which hardcode this poly internally.
 static constexpr uint32_t P = 0x82f63b78U;
 
+uint32_t crc32c_hardware(const void* M, size_t bytes, uint32_t prev);
+
 // OPTION 11
-uint32_t option_11_hardware_1_byte(const void* M, uint32_t bytes)
+CRC_TARGET_SSE42 uint32_t option_11_hardware_1_byte(const void* M, size_t bytes)
 {
     const uint8_t* M8 = (const uint8_t*)M;
     uint32_t R = 0;
-    for (uint32_t i = 0; i < bytes; ++i)
+    for (size_t i = 0; i < bytes; ++i)
     {
         R = _mm_crc32_u8(R, M8[i]);
     }
@@ -18,13 +24,63 @@ uint32_t option_11_hardware_1_byte(const void* M, uint32_t bytes)
 }
 
 // OPTION 12
-uint32_t option_12_hardware_8_bytes(const void* M, uint32_t bytes)
+CRC_TARGET_SSE42 uint32_t option_12_hardware_8_bytes(const void* M, size_t bytes)
 {
-    const uint64_t* M64 = (const uint64_t*)M;
-    uint64_t R = 0;
-    for (uint32_t i = 0; i < bytes >> 3; ++i)
+    return crc32c_hardware(M, bytes, 0);
+}
+
+// Option 12 with a starting CRC. crc32c() doesn't use it: without
+// PCLMULQDQ it runs the golden method with a software merge. this is what
+// Crc32cStream runs its short updates and filled tails through, where the
+// golden setup costs more than it saves. any length and alignment: crc32
+// comes in 1, 2, 4 and 8 byte widths, so a head or tail of up to 7 bytes
+// is at most 3 steps.
+CRC_TARGET_SSE42 uint32_t crc32c_hardware(const void* M, size_t bytes, uint32_t prev)
+{
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint64_t R = prev;
+    if (bytes >= 8)
     {
-        R = _mm_crc32_u64(R, M64[i]);
+        if ((uintptr_t)M8 & 1)
+        {
+            R = _mm_crc32_u8((uint32_t)R, *M8);
+            M8 += 1;
+            bytes -= 1;
+        }
+        if ((uintptr_t)M8 & 2)
+        {
+            R = _mm_crc32_u16((uint32_t)R, *(const uint16_t*)M8);
+            M8 += 2;
+            bytes -= 2;
+        }
+        if ((uintptr_t)M8 & 4)
+        {
+            R = _mm_crc32_u32((uint32_t)R, *(const uint32_t*)M8);
+            M8 += 4;
+            bytes -= 4;
+        }
     }
+
+    for (; bytes >= 8; bytes -= 8, M8 += 8)
+        R = _mm_crc32_u64(R, *(const uint64_t*)M8);
+
+    // under 8 bytes there was no alignment step, so these may be misaligned
+    if (bytes & 4)
+    {
+        uint32_t W;
+        memcpy(&W, M8, 4);
+        R = _mm_crc32_u32((uint32_t)R, W);
+        M8 += 4;
+    }
+    if (bytes & 2)
+    {
+        uint16_t W;
+        memcpy(&W, M8, 2);
+        R = _mm_crc32_u16((uint32_t)R, W);
+        M8 += 2;
+    }
+    if (bytes & 1)
+        R = _mm_crc32_u8((uint32_t)R, *M8);
+
     return (uint32_t)R;
 }
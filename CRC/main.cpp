@@ -1,45 +1,301 @@
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <immintrin.h>
+#include <new>
 #include <random>
+#include <thread>
+
+#include "cpu_features.h"
+#include "crc32c.h"
+#include "crc32c_fixed.h"
+#include "crc32c_stream.h"
+#include "golden_intel.h"
+#include "golden_tuned.h"
+#include "tabular_methods.h"
 
 static constexpr bool kPrintTables = false;
 
+// run only the correctness checks and skip every benchmark: for Debug and
+// sanitizer builds (-fsanitize=undefined), where the timings mean nothing
+static constexpr bool kChecksOnly = false;
+
 using namespace std::chrono;
 
 void tabular_method_table_print_demo();
 void golden_lut_print_demo_intel();
 void golden_lut_print_demo_amd();
+void golden_lut_print_demo_32();
+
+extern "C"
+{
+    uint32_t option_1_cf_jump(const void* M, size_t bytes);
+    uint32_t option_2_multiply_mask(const void* M, size_t bytes);
+    uint32_t option_3_bit_mask(const void* M, size_t bytes);
+    uint32_t option_4_cmove(const void* M, size_t bytes);
+}
+
+uint32_t option_5_naive_cpp(const void* M, size_t bytes);
+
+uint32_t option_6_tabular_1_byte(const void* M, size_t bytes);
+uint32_t option_7_tabular_2_bytes(const void* M, size_t bytes);
+uint32_t option_8_tabular_4_bytes(const void* M, size_t bytes);
+uint32_t option_9_tabular_8_bytes(const void* M, size_t bytes);
+uint32_t option_10_tabular_16_bytes(const void* M, size_t bytes);
+uint32_t option_10_tabular_16_bytes_ieee(const void* M, size_t bytes);
+uint32_t option_10_tabular_8_bytes_generic(const void* M, size_t bytes);
+uint32_t option_10_tabular_16_bytes_generic(const void* M, size_t bytes);
+uint32_t option_10_tabular_32_bytes(const void* M, size_t bytes);
+uint32_t option_10_tabular_64_bytes(const void* M, size_t bytes);
+uint32_t option_10_tabular_wide_4_bytes(const void* M, size_t bytes);
+uint32_t option_10_tabular_wide_8_bytes(const void* M, size_t bytes);
+uint32_t option_10_tabular_wide_16_bytes(const void* M, size_t bytes);
+
+uint32_t option_25_nibble_1_byte(const void* M, size_t bytes);
+uint32_t option_25_nibble_4_bytes(const void* M, size_t bytes);
+uint32_t option_26_tabular_shared_1_byte(const void* M, size_t bytes);
+
+uint32_t option_27_tabular_braided_3(const void* M, size_t bytes, uint32_t prev = 0);
+uint32_t option_27_tabular_braided_4(const void* M, size_t bytes, uint32_t prev = 0);
+uint32_t option_27_tabular_braided_5(const void* M, size_t bytes, uint32_t prev = 0);
+uint32_t option_27_tabular_braided_4_ieee(const void* M, size_t bytes, uint32_t prev = 0);
+
+uint32_t option_11_hardware_1_byte(const void* M, size_t bytes);
+uint32_t option_12_hardware_8_bytes(const void* M, size_t bytes);
+uint32_t crc32c_hardware(const void* M, size_t bytes, uint32_t prev);
+uint32_t crc32c_tabular(const void* M, size_t bytes, uint32_t prev);
+
+uint32_t option_13_golden_intel(const void* M, size_t bytes, uint32_t prev = 0);
+uint32_t option_13_golden_soft(const void* M, size_t bytes, uint32_t prev = 0);
+uint32_t option_14_golden_amd(const void* M, size_t bytes, uint32_t prev = 0);
+uint32_t option_13_golden_intel_32(const void* M, size_t bytes, uint32_t prev = 0);
+uint32_t option_14_golden_amd_32(const void* M, size_t bytes, uint32_t prev = 0);
 
+uint32_t option_15_golden_avx512(const void* M, size_t bytes, uint32_t prev = 0);
+
+// the hand-written GAS versions of Options 13 and 14 are System V only
+#if defined(__x86_64__) && !defined(_WIN32)
+#define HAS_SYSV_GOLDEN 1
 extern "C"
 {
-    uint32_t option_1_cf_jump(const void* M, uint32_t bytes);
-    uint32_t option_2_multiply_mask(const void* M, uint32_t bytes);
-    uint32_t option_3_bit_mask(const void* M, uint32_t bytes);
-    uint32_t option_4_cmove(const void* M, uint32_t bytes);
+    uint32_t option_13_golden_intel_asm(const void* M, size_t bytes, uint32_t prev);
+    uint32_t option_14_golden_amd_asm(const void* M, size_t bytes, uint32_t prev);
+}
+#else
+#define HAS_SYSV_GOLDEN 0
+#endif
+
+uint32_t option_16_folding_castagnoli(const void* M, size_t bytes);
+uint32_t option_16_folding_ieee(const void* M, size_t bytes);
+
+uint32_t option_17_golden_fusion(const void* M, size_t bytes, uint32_t prev = 0);
+
+uint64_t option_18_crc64_naive(const void* M, size_t bytes);
+uint64_t option_19_crc64_tabular_8_bytes(const void* M, size_t bytes);
+uint64_t option_20_crc64_tabular_16_bytes(const void* M, size_t bytes);
+uint64_t option_21_crc64_folding(const void* M, size_t bytes);
+uint64_t option_21_crc64_folding_xz(const void* M, size_t bytes);
+uint64_t option_18_crc64_naive_ecma(const void* M, size_t bytes);
+uint64_t option_20_crc64_tabular_16_bytes_ecma(const void* M, size_t bytes);
+uint64_t option_21_crc64_folding_ecma(const void* M, size_t bytes);
+
+uint32_t option_22_t10dif_1_byte(const void* M, size_t bytes);
+uint32_t option_22_t10dif_8_bytes(const void* M, size_t bytes);
+uint32_t option_22_t10dif_16_bytes(const void* M, size_t bytes);
+uint32_t option_22_smbus_16_bytes(const void* M, size_t bytes);
+uint32_t option_23_t10dif_folding(const void* M, size_t bytes);
+uint32_t option_23_smbus_folding(const void* M, size_t bytes);
+uint32_t option_10_tabular_16_bytes_ccitt(const void* M, size_t bytes);
+uint32_t option_16_folding_ccitt(const void* M, size_t bytes);
+
+uint32_t option_5_naive_mpeg2(const void* M, size_t bytes);
+uint32_t option_22_mpeg2_8_bytes(const void* M, size_t bytes);
+uint32_t option_22_mpeg2_16_bytes(const void* M, size_t bytes);
+uint32_t option_23_mpeg2_folding(const void* M, size_t bytes);
+
+void option_10_batch_ieee(const void* const* ptrs, const size_t* lens, uint32_t* out, size_t count);
+void gather_batch_ieee(const void* const* ptrs, const size_t* lens, uint32_t* out, size_t count);
+
+static uint32_t crc32c_dispatch(const void* M, size_t bytes, uint32_t prev)
+{
+    return crc32c(M, bytes, prev);
+}
+
+// crc32c_fixed<N> against golden at the same size, over independent
+// records (the CRCs are xored together only so they can't be dropped)
+template <size_t N>
+static void bench_fixed(const uint8_t* M, size_t bytes)
+{
+    const size_t runs = ((size_t)256 << 20) / N;
+    const size_t records = bytes / N;
+    double ns[2];
+    uint32_t result[2] = {};
+    for (uint32_t k = 0; k < 2; ++k)
+    {
+        auto start = high_resolution_clock::now();
+        for (size_t i = 0; i < runs; ++i)
+        {
+            const uint8_t* record = M + (i % records) * N;
+            result[k] ^= k ? option_13_golden_intel(record, N) : crc32c_fixed<N>(record);
+        }
+        auto end = high_resolution_clock::now();
+        ns[k] = (double)(duration_cast<nanoseconds>(end - start).count()) / runs;
+    }
+
+    printf(" %6zu | %8.1f ns | %8.1f MB/s | %8.1f ns | %8.1f MB/s%s\n", N, ns[0], N / ns[0] * 1e3, ns[1], N / ns[1] * 1e3,
+        result[0] == result[1] ? "" : " MISMATCH");
+}
+
+// Option 13 against golden_intel<Flags> with more and more of its edge
+// handling compiled out, over N-byte records. each CRC feeds the next
+// call's prev, so the time is the latency the edge handling adds. N is a
+// whole number of leaves and M is 8-byte aligned, so every contract holds.
+// the differences are a few ns, under the run-to-run noise of one long
+// timing, so each variant is timed in many short rounds, interleaved and
+// in a rotating order, and the medians are compared.
+template <size_t N>
+static void bench_contract(const uint8_t* M, size_t bytes)
+{
+    static_assert(N % LEAF_SIZE_INTEL == 0, "records must satisfy every contract");
+    typedef uint32_t(*Kernel)(const void*, size_t, uint32_t);
+    static const Kernel kernels[] = {
+        golden_intel<0>,
+        golden_intel<AlignedTo8>,
+        golden_intel<AlignedTo8 | LengthMultipleOf8>,
+        golden_intel<AlignedTo8 | LengthMultipleOfLeaf>,
+    };
+    constexpr uint32_t kKernels = sizeof(kernels) / sizeof(kernels[0]);
+
+    constexpr uint32_t kRounds = 31;
+
+    const size_t runs = ((size_t)256 << 20) / N / kRounds;
+    const size_t records = bytes / N;
+    double samples[kKernels][kRounds];
+    uint32_t result[kKernels] = {};
+    for (uint32_t round = 0; round < kRounds; ++round)
+    {
+        for (uint32_t j = 0; j < kKernels; ++j)
+        {
+            const uint32_t k = (j + round) % kKernels;
+            auto start = high_resolution_clock::now();
+            for (size_t i = 0; i < runs; ++i)
+                result[k] = kernels[k](M + (i % records) * N, N, result[k]);
+            auto end = high_resolution_clock::now();
+            samples[k][round] = (double)(duration_cast<nanoseconds>(end - start).count()) / runs;
+        }
+    }
+
+    double ns[kKernels];
+    for (uint32_t k = 0; k < kKernels; ++k)
+    {
+        std::nth_element(samples[k], samples[k] + kRounds / 2, samples[k] + kRounds);
+        ns[k] = samples[k][kRounds / 2];
+    }
+
+    bool match = true;
+    for (uint32_t k = 1; k < kKernels; ++k)
+        match &= result[k] == result[0];
+
+    // approximating CPU clock as 4 GHz
+    printf(" %6zu | %7.1f ns | %7.1f ns | %7.1f ns | %7.1f ns | %5.1f%s\n", N, ns[0], ns[1], ns[2], ns[3],
+        4 * (ns[0] - ns[3]), match ? "" : " MISMATCH");
+}
+
+// median ns of one call on an N-byte block, less the clock's own cost.
+// when cold, every line of the kernel's tables is flushed first, as for a
+// block checksummed once per frame; the block itself stays warm, so the
+// difference is what the table misses cost.
+static double bench_table_cache(uint32_t(*f)(const void*, size_t), const void* tbl, size_t tblBytes, const uint8_t* M, size_t N, bool cold, uint32_t* result)
+{
+    constexpr size_t kSamples = 501;
+    double ns[kSamples];
+    double overhead[kSamples];
+    uint32_t R = 0;
+    for (size_t i = 0; i < kSamples; ++i)
+    {
+        if (cold)
+        {
+            for (size_t off = 0; off < tblBytes; off += 64)
+                _mm_clflush((const uint8_t*)tbl + off);
+            _mm_mfence();
+            _mm_lfence();
+        }
+
+        auto start = high_resolution_clock::now();
+        R ^= f(M, N);
+        auto end = high_resolution_clock::now();
+        auto empty = high_resolution_clock::now();
+        ns[i] = (double)duration_cast<nanoseconds>(end - start).count();
+        overhead[i] = (double)duration_cast<nanoseconds>(empty - end).count();
+    }
+
+    std::nth_element(ns, ns + kSamples / 2, ns + kSamples);
+    std::nth_element(overhead, overhead + kSamples / 2, overhead + kSamples);
+    *result = R;
+    return std::max(0.0, ns[kSamples / 2] - overhead[kSamples / 2]);
 }
 
-uint32_t option_5_naive_cpp(const void* M, uint32_t bytes);
+// average ns per call of a prev-taking kernel over independent N-byte
+// records at every offset, so the alignment prologue is exercised too
+static double bench_records(uint32_t(*f)(const void*, size_t, uint32_t), const uint8_t* M, size_t bytes, size_t N, uint32_t* result)
+{
+    const size_t runs = ((size_t)256 << 20) / N;
+    const size_t records = bytes / N;
+    uint32_t R = 0;
+    auto start = high_resolution_clock::now();
+    for (size_t i = 0; i < runs; ++i)
+        R ^= f(M + (i % records) * N, N, 0);
+    auto end = high_resolution_clock::now();
+    *result = R;
+    return (double)(duration_cast<nanoseconds>(end - start).count()) / runs;
+}
 
-uint32_t option_6_tabular_1_byte(const void* M, uint32_t bytes);
-uint32_t option_7_tabular_2_bytes(const void* M, uint32_t bytes);
-uint32_t option_8_tabular_4_bytes(const void* M, uint32_t bytes);
-uint32_t option_9_tabular_8_bytes(const void* M, uint32_t bytes);
-uint32_t option_10_tabular_16_bytes(const void* M, uint32_t bytes);
+// Options 7-10 and 12 take any length and alignment: every start offset in
+// a 16-byte line and every length up to a few blocks, against Option 6.
+// crc32c()'s fallbacks are checked the same way, with a starting CRC.
+// this is cheap, so it runs before any benchmark; see kChecksOnly.
+static size_t check_any_length(const uint8_t* M, bool kHasHardware)
+{
+    typedef uint32_t(*Kernel)(const void*, size_t);
+    const Kernel kernels[] = {
+        option_7_tabular_2_bytes, option_8_tabular_4_bytes, option_9_tabular_8_bytes,
+        option_10_tabular_16_bytes, kHasHardware ? option_12_hardware_8_bytes : option_6_tabular_1_byte,
+    };
+    constexpr uint32_t kPrev = 0x9e3779b9U;
 
-uint32_t option_11_hardware_1_byte(const void* M, uint32_t bytes);
-uint32_t option_12_hardware_8_bytes(const void* M, uint32_t bytes);
+    size_t bad = 0;
+    for (size_t offset = 0; offset < 16; ++offset)
+    {
+        for (size_t len = 0; len < 100; ++len)
+        {
+            const uint32_t expected = option_6_tabular_1_byte(M + offset, len);
+            for (const Kernel f : kernels)
+                bad += f(M + offset, len) != expected;
 
-uint32_t option_13_golden_intel(const void* M, uint32_t bytes, uint32_t prev = 0);
-uint32_t option_14_golden_amd(const void* M, uint32_t bytes, uint32_t prev = 0);
+            const uint32_t expectedPrev = crc32c_tabular(M + offset, len, kPrev);
+            bad += tabular_1_byte<0x82f63b78U>(M + offset, len, kPrev) != expectedPrev;
+            if (kHasHardware)
+                bad += crc32c_hardware(M + offset, len, kPrev) != expectedPrev;
+        }
+    }
+    return bad;
+}
 
 int main()
 {
+    const CpuFeatures& cpu = get_cpu_features();
+    const bool kHasHardware = cpu.m_sse42;
+    const bool kHasGolden = cpu.m_sse42 && cpu.m_pclmul;
+    const bool kHasAvx512 = kHasGolden && cpu.m_avx512f && cpu.m_vpclmul;
+
     if (kPrintTables)
     {
         tabular_method_table_print_demo();
         golden_lut_print_demo_intel();
         golden_lut_print_demo_amd();
+        golden_lut_print_demo_32();
     }
 
     constexpr size_t seed = 5;
@@ -53,25 +309,38 @@ int main()
         const char* m_name;
         union
         {
-            uint32_t(*m_fNoPrev)(const void*, uint32_t);
-            uint32_t(*m_fPrev)(const void*, uint32_t, uint32_t);
+            uint32_t(*m_fNoPrev)(const void*, size_t);
+            uint32_t(*m_fPrev)(const void*, size_t, uint32_t);
+            uint64_t(*m_f64)(const void*, size_t);
         };
         size_t m_runs;
         bool m_hasPrev;
+        bool m_is64;
 
-        TestItem(const char* name, uint32_t(*fNoPrev)(const void*, uint32_t), size_t runs) :
+        TestItem(const char* name, uint32_t(*fNoPrev)(const void*, size_t), size_t runs) :
             m_name(name),
             m_fNoPrev(fNoPrev),
             m_runs(runs),
-            m_hasPrev(false)
+            m_hasPrev(false),
+            m_is64(false)
         {
         }
 
-        TestItem(const char* name, uint32_t(*fPrev)(const void*, uint32_t, uint32_t), size_t runs) :
+        TestItem(const char* name, uint32_t(*fPrev)(const void*, size_t, uint32_t), size_t runs) :
             m_name(name),
             m_fPrev(fPrev),
             m_runs(runs),
-            m_hasPrev(true)
+            m_hasPrev(true),
+            m_is64(false)
+        {
+        }
+
+        TestItem(const char* name, uint64_t(*f64)(const void*, size_t), size_t runs) :
+            m_name(name),
+            m_f64(f64),
+            m_runs(runs),
+            m_hasPrev(false),
+            m_is64(true)
         {
         }
     };
@@ -86,11 +355,22 @@ int main()
         M[i] = dis(gen);
     }
 
+    printf("CPU: %s family 0x%x model 0x%x\n", cpu.m_vendor, cpu.m_family, cpu.m_model);
+    printf("crc32c() dispatches to: %s\n\n", crc32c_kernel_name());
+
+    const size_t anyLengthBad = check_any_length(M, kHasHardware);
+    printf("Options 7-10, 12 on unaligned, odd-length buffers: %s\n\n", anyLengthBad ? "MISMATCH" : "OK");
+    if (kChecksOnly)
+    {
+        delete[] M;
+        return anyLengthBad ? 1 : 0;
+    }
+
     printf("Starting tests...\n\n");
 
-    printf("--------------------------------|------------|---------------------------------\n");
-    printf(" Option                         | Result     | Performance\n");
-    printf("--------------------------------|------------|---------------------------------\n");
+    printf("--------------------------------|--------------------|---------------------------------\n");
+    printf(" Option                         | Result             | Performance\n");
+    printf("--------------------------------|--------------------|---------------------------------\n");
 
     TestItem items[] = {
         TestItem("Option 1:  Naive    - CF Jump ",	option_1_cf_jump,			    20),
@@ -99,21 +379,79 @@ int main()
         TestItem("Option 5:  Naive    - CPP     ",	option_5_naive_cpp,			    60),
         TestItem("Option 4:  Naive    - Cmove   ",	option_4_cmove,				    60),
         TestItem("Option 6:  Tabular  - 1 byte  ",	option_6_tabular_1_byte,	    180),
+        TestItem("Option 25: Nibble   - 1 byte  ",	option_25_nibble_1_byte,	    100),
+        TestItem("Option 25: Nibble   - 4 bytes ",	option_25_nibble_4_bytes,	    300),
+        TestItem("Option 26: Shared   - 1 byte  ",	option_26_tabular_shared_1_byte,180),
         TestItem("Option 7:  Tabular  - 2 bytes ",	option_7_tabular_2_bytes,	    300),
-        TestItem("Option 11: Hardware - 1 byte  ",	option_11_hardware_1_byte,	    500),
+        TestItem("Option 11: Hardware - 1 byte  ",	option_11_hardware_1_byte,	    kHasHardware ? 500 : 0),
         TestItem("Option 8:  Tabular  - 4 bytes ",	option_8_tabular_4_bytes,	    600),
         TestItem("Option 9:  Tabular  - 8 bytes ",	option_9_tabular_8_bytes,	    1100),
         TestItem("Option 10: Tabular  - 16 bytes",	option_10_tabular_16_bytes,	    1500),
-        TestItem("Option 12: Hardware - 8 bytes ",	option_12_hardware_8_bytes,	    5000),
-        TestItem("Option 14: Golden   - AMD     ",	option_14_golden_amd,		    9000),
-        TestItem("Option 13: Golden   - Intel   ",	option_13_golden_intel,		    10000),
+        TestItem("Option 10: Tabular  - 16 IEEE ",	option_10_tabular_16_bytes_ieee,1500),
+        TestItem("Option 10: Tabular  - 8 gen   ",	option_10_tabular_8_bytes_generic, 1100),
+        TestItem("Option 10: Tabular  - 16 gen  ",	option_10_tabular_16_bytes_generic,1500),
+        TestItem("Option 10: Tabular  - 32 bytes",	option_10_tabular_32_bytes,	    1500),
+        TestItem("Option 10: Tabular  - 64 bytes",	option_10_tabular_64_bytes,	    1500),
+        TestItem("Option 10: Tab 64K  - 4 bytes ",	option_10_tabular_wide_4_bytes, 1100),
+        TestItem("Option 10: Tab 64K  - 8 bytes ",	option_10_tabular_wide_8_bytes, 1100),
+        TestItem("Option 10: Tab 64K  - 16 bytes",	option_10_tabular_wide_16_bytes,1100),
+        TestItem("Option 27: Braided  - 3 x 8   ",	option_27_tabular_braided_3,    2000),
+        TestItem("Option 27: Braided  - 4 x 8   ",	option_27_tabular_braided_4,    2000),
+        TestItem("Option 27: Braided  - 5 x 8   ",	option_27_tabular_braided_5,    2000),
+        TestItem("Option 27: Braided  - 4 IEEE  ",	option_27_tabular_braided_4_ieee,2000),
+        TestItem("Option 16: Folding  - CRC32C  ",	option_16_folding_castagnoli,   kHasGolden ? 6000 : 0),
+        TestItem("Option 16: Folding  - IEEE    ",	option_16_folding_ieee,		    kHasGolden ? 6000 : 0),
+        TestItem("Option 12: Hardware - 8 bytes ",	option_12_hardware_8_bytes,	    kHasHardware ? 5000 : 0),
+        TestItem("Option 14: Golden   - AMD     ",	option_14_golden_amd,		    kHasGolden ? 9000 : 0),
+        TestItem("Option 13: Golden   - Intel   ",	option_13_golden_intel,		    kHasGolden ? 10000 : 0),
+        TestItem("Option 14: Golden   - AMD 32  ",	option_14_golden_amd_32,	    kHasGolden ? 9000 : 0),
+        TestItem("Option 13: Golden   - Intel 32",	option_13_golden_intel_32,	    kHasGolden ? 10000 : 0),
+        TestItem("Option 13: Golden   - SW clmul",	option_13_golden_soft,		    kHasHardware ? 10000 : 0),
+#if HAS_SYSV_GOLDEN
+        TestItem("Option 14: Golden asm - AMD   ",	option_14_golden_amd_asm,	    kHasGolden ? 9000 : 0),
+        TestItem("Option 13: Golden asm - Intel ",	option_13_golden_intel_asm,	    kHasGolden ? 10000 : 0),
+#endif
+        TestItem("Option 17: Golden   - Fusion  ",	option_17_golden_fusion,	    kHasGolden ? 15000 : 0),
+        TestItem("Option 15: Golden   - AVX-512 ",	option_15_golden_avx512,	    kHasAvx512 ? 20000 : 0),
+        TestItem("crc32c():  Dispatch           ",	crc32c_dispatch,			    15000),
+        TestItem("Option 18: CRC-64   - Naive   ",	option_18_crc64_naive,		    60),
+        TestItem("Option 19: CRC-64   - 8 bytes ",	option_19_crc64_tabular_8_bytes, 1100),
+        TestItem("Option 20: CRC-64   - 16 bytes",	option_20_crc64_tabular_16_bytes,1500),
+        TestItem("Option 21: CRC-64   - Folding ",	option_21_crc64_folding,	    kHasGolden ? 6000 : 0),
+        TestItem("Option 21: CRC-64   - XZ      ",	option_21_crc64_folding_xz,	    kHasGolden ? 6000 : 0),
+        TestItem("Option 18: ECMA-182 - Naive   ",	option_18_crc64_naive_ecma,	    60),
+        TestItem("Option 20: ECMA-182 - 16 bytes",	option_20_crc64_tabular_16_bytes_ecma,1500),
+        TestItem("Option 21: ECMA-182 - Folding ",	option_21_crc64_folding_ecma,   kHasGolden ? 6000 : 0),
+        TestItem("Option 22: T10-DIF  - 1 byte  ",	option_22_t10dif_1_byte,	    180),
+        TestItem("Option 22: T10-DIF  - 8 bytes ",	option_22_t10dif_8_bytes,	    1100),
+        TestItem("Option 22: T10-DIF  - 16 bytes",	option_22_t10dif_16_bytes,	    1500),
+        TestItem("Option 23: T10-DIF  - Folding ",	option_23_t10dif_folding,	    kHasGolden ? 6000 : 0),
+        TestItem("Option 10: CCITT    - 16 bytes",	option_10_tabular_16_bytes_ccitt,1500),
+        TestItem("Option 16: CCITT    - Folding ",	option_16_folding_ccitt,	    kHasGolden ? 6000 : 0),
+        TestItem("Option 22: SMBUS    - 16 bytes",	option_22_smbus_16_bytes,	    1500),
+        TestItem("Option 23: SMBUS    - Folding ",	option_23_smbus_folding,	    kHasGolden ? 6000 : 0),
+        TestItem("Option 5:  MPEG-2   - Naive   ",	option_5_naive_mpeg2,		    60),
+        TestItem("Option 22: MPEG-2   - 8 bytes ",	option_22_mpeg2_8_bytes,	    1100),
+        TestItem("Option 22: MPEG-2   - 16 bytes",	option_22_mpeg2_16_bytes,	    1500),
+        TestItem("Option 23: MPEG-2   - Folding ",	option_23_mpeg2_folding,	    kHasGolden ? 6000 : 0),
     };
 
     for (const TestItem& item : items)
     {
-        uint32_t result = 0;
+        if (!item.m_runs)
+        {
+            printf(" %s | ------------------ | not supported on this CPU\n", item.m_name);
+            continue;
+        }
+
+        uint64_t result = 0;
         auto start = high_resolution_clock::now();
-        if (item.m_hasPrev)
+        if (item.m_is64)
+        {
+            for (size_t i = 0; i < item.m_runs; ++i)
+                result = item.m_f64(M, kBytes);
+        }
+        else if (item.m_hasPrev)
         {
             for (size_t i = 0; i < item.m_runs; ++i)
                 result = item.m_fPrev(M, kBytes, 0);
@@ -127,11 +465,435 @@ int main()
         auto end = high_resolution_clock::now();
         const double ns = (double)(duration_cast<nanoseconds>(end - start).count()) / item.m_runs;
 
+        char resultStr[32];
+        if (item.m_is64)
+            snprintf(resultStr, sizeof(resultStr), "0x%016llx", (unsigned long long)result);
+        else
+            snprintf(resultStr, sizeof(resultStr), "0x%08x        ", (uint32_t)result);
+
         // approximating CPU clock as 4 GHz
-        printf(" %s | 0x%08x | %7.1f MB/s | %.2f bits/cycle\n", item.m_name, result, kBytes / ns * 1e3, 2 * kBytes / ns);
+        printf(" %s | %s | %7.1f MB/s | %.2f bits/cycle\n", item.m_name, resultStr, kBytes / ns * 1e3, 2 * kBytes / ns);
+    }
+
+    printf("--------------------------------|--------------------|---------------------------------\n");
+
+    if (kHasGolden)
+    {
+        printf("\ncrc32c_fixed<N>() vs Option 13 on N-byte records:\n");
+        printf("      N |          fixed           |         golden\n");
+        bench_fixed<16>(M, kBytes);
+        bench_fixed<32>(M, kBytes);
+        bench_fixed<64>(M, kBytes);
+        bench_fixed<512>(M, kBytes);
+        bench_fixed<4096>(M, kBytes);
+        bench_fixed<65536>(M, kBytes);
+
+        printf("\nOption 13 vs golden_intel<Flags> on N-byte records, median ns of interleaved rounds (cycles saved at 4 GHz):\n");
+        printf("      N |  Option 13 | AlignedTo8 | + LenMul8  | + LenLeaf  | saved\n");
+        bench_contract<144>(M, kBytes);
+        bench_contract<288>(M, kBytes);
+        bench_contract<576>(M, kBytes);
+        bench_contract<1152>(M, kBytes);
+        bench_contract<2304>(M, kBytes);
+        bench_contract<4608>(M, kBytes);
+        printf("(a saving of a few cycles or less is within run-to-run noise)\n");
+    }
+
+#if HAS_SYSV_GOLDEN
+    if (kHasGolden)
+    {
+        typedef uint32_t(*Kernel)(const void*, size_t, uint32_t);
+        static const Kernel kernels[] = { option_13_golden_intel, option_13_golden_intel_asm, option_14_golden_amd, option_14_golden_amd_asm };
+        static const size_t sizes[] = { 150, 300, 600, 1200, 2400, 4800, 6000 };
+
+        printf("\nOptions 13 and 14, C++ switch vs asm computed jump, on N-byte records (MB/s):\n");
+        printf("      N |  13 C++ |  13 asm |  14 C++ |  14 asm\n");
+        for (size_t N : sizes)
+        {
+            uint32_t result[4];
+            double ns[4];
+            for (uint32_t k = 0; k < 4; ++k)
+                ns[k] = bench_records(kernels[k], M, kBytes, N, &result[k]);
+
+            printf(" %6zu | %7.1f | %7.1f | %7.1f | %7.1f%s\n", N, N / ns[0] * 1e3, N / ns[1] * 1e3, N / ns[2] * 1e3, N / ns[3] * 1e3,
+                result[0] == result[1] && result[0] == result[2] && result[0] == result[3] ? "" : " MISMATCH");
+        }
+    }
+#endif
+
+    // golden with its stream count, leaf size and cap measured on this
+    // machine, against Option 13 and against the same kernel at Option 13's
+    // settings
+    if (kHasGolden)
+    {
+        auto start = high_resolution_clock::now();
+        const GoldenTuning tuned = golden_tune();
+        auto end = high_resolution_clock::now();
+        printf("\ngolden_tune(): %u streams, %u-byte leaf, n capped at %u (took %.2f s)\n", tuned.m_streams, tuned.m_leafSize, tuned.m_maxN,
+            (double)duration_cast<milliseconds>(end - start).count() / 1e3);
+
+        static const size_t sizes[] = { 256, 1024, 4096, 16384, 65536, 262144 };
+        printf("      N | Option 13 | default  |  tuned   (MB/s)\n");
+        for (size_t N : sizes)
+        {
+            uint32_t result[3];
+            double ns[3];
+            ns[0] = bench_records(option_13_golden_intel, M, kBytes, N, &result[0]);
+            golden_apply_tuning(golden_default_tuning());
+            ns[1] = bench_records(golden_tuned, M, kBytes, N, &result[1]);
+            golden_apply_tuning(tuned);
+            ns[2] = bench_records(golden_tuned, M, kBytes, N, &result[2]);
+
+            printf(" %6zu | %9.1f | %8.1f | %8.1f%s\n", N, N / ns[0] * 1e3, N / ns[1] * 1e3, N / ns[2] * 1e3,
+                result[0] == result[1] && result[0] == result[2] ? "" : " MISMATCH");
+        }
+    }
+
+    // what crc32c() falls back to without PCLMULQDQ, against what it used
+    // to fall back to and what it would run with PCLMULQDQ. the software
+    // merge only closes on the pclmul one somewhere past 4 KiB; see
+    // golden_soft.cpp.
+    if (kHasHardware)
+    {
+        static const size_t sizes[] = { 256, 1024, 4096, 16384, 65536 };
+        printf("\nWithout PCLMULQDQ, on N-byte records (MB/s):\n");
+        printf("      N | Hardware 8 bytes | Golden SW clmul | Golden (PCLMUL)\n");
+        for (size_t N : sizes)
+        {
+            uint32_t result[3];
+            double ns[3];
+            ns[0] = bench_records(crc32c_hardware, M, kBytes, N, &result[0]);
+            ns[1] = bench_records(option_13_golden_soft, M, kBytes, N, &result[1]);
+            ns[2] = kHasGolden ? bench_records(option_13_golden_intel, M, kBytes, N, &result[2]) : 0;
+            if (!kHasGolden)
+                result[2] = result[0];
+
+            printf(" %6zu | %16.1f | %15.1f | %15.1f%s\n", N, N / ns[0] * 1e3, N / ns[1] * 1e3, kHasGolden ? N / ns[2] * 1e3 : 0.0,
+                result[0] == result[1] && result[0] == result[2] ? "" : " MISMATCH");
+        }
+    }
+
+    // Option 27 at every length through two of its largest passes and at
+    // a few offsets, against Option 10 with the same poly
+    {
+        typedef uint32_t(*Kernel)(const void*, size_t, uint32_t);
+        const Kernel kernels[] = { option_27_tabular_braided_3, option_27_tabular_braided_4, option_27_tabular_braided_5 };
+
+        size_t bad = 0;
+        for (size_t offset = 0; offset < 8; offset += 3)
+        {
+            for (size_t len = 0; len < 2 * 5 * 256 + 64; ++len)
+            {
+                const uint32_t expected = option_10_tabular_16_bytes(M + offset, len);
+                for (const Kernel f : kernels)
+                    bad += f(M + offset, len, 0) != expected;
+                bad += option_27_tabular_braided_4_ieee(M + offset, len, 0) != option_10_tabular_16_bytes_ieee(M + offset, len);
+            }
+        }
+        printf("Option 27 at every length and a few offsets: %s\n", bad ? "MISMATCH" : "OK");
+
+        // where the streams start to pay for their join, if they do at all
+        static const size_t sizes[] = { 256, 768, 1024, 1280, 4096, 16384, 65536, kBytes };
+        const Kernel tabular[] = { crc32c_tabular, option_27_tabular_braided_3, option_27_tabular_braided_4, option_27_tabular_braided_5 };
+        printf("\nOption 10 vs Option 27 on N-byte records (MB/s):\n");
+        printf("      N | Option 10 | 3 streams | 4 streams | 5 streams\n");
+        for (size_t N : sizes)
+        {
+            uint32_t result[4];
+            double ns[4];
+            for (uint32_t k = 0; k < 4; ++k)
+                ns[k] = bench_records(tabular[k], M, kBytes, N, &result[k]);
+
+            printf(" %6zu | %9.1f | %9.1f | %9.1f | %9.1f%s\n", N, N / ns[0] * 1e3, N / ns[1] * 1e3, N / ns[2] * 1e3, N / ns[3] * 1e3,
+                result[0] == result[1] && result[0] == result[2] && result[0] == result[3] ? "" : " MISMATCH");
+        }
+    }
+
+    // the same kernels with their tables flushed before every call and
+    // with them warm, to choose by the cache state a call will find
+    {
+        constexpr uint32_t kCastagnoli = 0x82f63b78U;
+        struct ColdItem
+        {
+            const char* m_name;
+            uint32_t(*m_f)(const void*, size_t);
+            const void* m_tbl;
+            size_t m_tblBytes;
+        };
+
+        const ColdItem coldItems[] = {
+            { "Option 6:  Tabular  - 1 byte  ", option_6_tabular_1_byte, TabularTablesFor<kCastagnoli, 1>::kTables.m_tbl, sizeof(TabularTables<kCastagnoli, 1>) },
+            { "Option 10: Tabular  - 16 bytes", option_10_tabular_16_bytes, TabularTablesFor<kCastagnoli, 16>::kTables.m_tbl, sizeof(TabularTables<kCastagnoli, 16>) },
+            { "Option 25: Nibble   - 1 byte  ", option_25_nibble_1_byte, NibbleTablesFor<kCastagnoli, 1>::kTables.m_tbl, sizeof(NibbleTables<kCastagnoli, 1>) },
+            { "Option 25: Nibble   - 4 bytes ", option_25_nibble_4_bytes, NibbleTablesFor<kCastagnoli, 8>::kTables.m_tbl, sizeof(NibbleTables<kCastagnoli, 8>) },
+            { "Option 26: Shared   - 1 byte  ", option_26_tabular_shared_1_byte, TabularTablesFor<kCastagnoli, 16>::kTables.m_tbl, sizeof(TabularTables<kCastagnoli, 1>) },
+            { "Option 12: Hardware - 8 bytes ", kHasHardware ? option_12_hardware_8_bytes : nullptr, nullptr, 0 },
+        };
+        static const size_t sizes[] = { 64, 256, 1024, 4096 };
+
+        printf("\nTables flushed before each call vs warm, median ns per call on an N-byte block:\n");
+        printf(" Option                         |  table  |    64 B cold/warm |   256 B cold/warm |  1024 B cold/warm |  4096 B cold/warm\n");
+        for (const ColdItem& item : coldItems)
+        {
+            if (!item.m_f)
+                continue;
+
+            printf(" %s | %5zu B", item.m_name, item.m_tblBytes);
+            bool ok = true;
+            for (size_t N : sizes)
+            {
+                uint32_t result[2];
+                const double cold = bench_table_cache(item.m_f, item.m_tbl, item.m_tblBytes, M, N, true, &result[0]);
+                const double warm = bench_table_cache(item.m_f, item.m_tbl, item.m_tblBytes, M, N, false, &result[1]);
+                ok &= result[0] == result[1];
+                printf(" | %7.0f / %6.0f", cold, warm);
+            }
+            printf("%s\n", ok ? "" : " MISMATCH");
+        }
+    }
+
+    // combine: checksum two pieces of M separately and join them, then
+    // time a dependent chain of combines so each one waits on the last
+    {
+        const size_t kSplit = kBytes / 3;
+        const uint32_t crcA = crc32c(M, kSplit);
+        const uint32_t crcB = crc32c(M + kSplit, kBytes - kSplit);
+        const bool ok = crc32c_combine(crcA, crcB, kBytes - kSplit) == crc32c(M, kBytes);
+        printf("\ncrc32c_combine() check: %s\n", ok ? "OK" : "MISMATCH");
+
+        constexpr size_t kCombineRuns = 1000000;
+        std::uniform_int_distribution<uint64_t> lenDis;
+        uint64_t lens[256];
+        for (const uint64_t maxLen : { (uint64_t)64 * 1024, ~(uint64_t)0 })
+        {
+            for (uint64_t& len : lens)
+                len = lenDis(gen) % maxLen;
+
+            uint32_t crc = 0;
+            auto start = high_resolution_clock::now();
+            for (size_t i = 0; i < kCombineRuns; ++i)
+                crc = crc32c_combine(crc, (uint32_t)i, lens[i & 255]);
+            auto end = high_resolution_clock::now();
+            const double ns = (double)(duration_cast<nanoseconds>(end - start).count()) / kCombineRuns;
+
+            // approximating CPU clock as 4 GHz
+            printf("crc32c_combine() latency, lenB < %s: %.1f ns | %.0f cycles (0x%08x)\n",
+                maxLen == ~(uint64_t)0 ? "2^64" : "64 KiB", ns, 4 * ns, crc);
+        }
+    }
+
+    // batches of independent packets cut from M, one at a time through
+    // crc32c() and all together through crc32c_batch(). for 64-256 byte
+    // packets crc32c() barely gets its 3 streams going and the batch should
+    // win clearly; for 64-1500 by less, since crc32c() does well on its own
+    // with the longer ones, and the batch hands those to it anyway.
+    {
+        constexpr size_t kPackets = 10000;
+        const void** ptrs = new const void*[kPackets];
+        size_t* lens = new size_t[kPackets];
+        uint32_t* crcs = new uint32_t[kPackets];
+        uint32_t* expected = new uint32_t[kPackets];
+        uint64_t* mismatches = new uint64_t[(kPackets + 63) / 64];
+        size_t totalBytes = 0;
+        constexpr size_t kBatchRuns = 100;
+
+        // 64-1500 last, so the IEEE comparison below runs on those packets
+        for (const size_t maxLen : { (size_t)256, (size_t)1500 })
+        {
+            std::uniform_int_distribution<size_t> lenDis(64, maxLen);
+            std::uniform_int_distribution<size_t> offDis(0, kBytes - maxLen);
+            totalBytes = 0;
+            for (size_t i = 0; i < kPackets; ++i)
+            {
+                ptrs[i] = M + offDis(gen);
+                lens[i] = lenDis(gen);
+                totalBytes += lens[i];
+            }
+
+            for (const bool batched : { false, true })
+            {
+                auto start = high_resolution_clock::now();
+                for (size_t r = 0; r < kBatchRuns; ++r)
+                {
+                    if (batched)
+                    {
+                        crc32c_batch(ptrs, lens, crcs, kPackets);
+                    }
+                    else
+                    {
+                        for (size_t i = 0; i < kPackets; ++i)
+                            expected[i] = crc32c(ptrs[i], lens[i]);
+                    }
+                }
+                auto end = high_resolution_clock::now();
+                const double ns = (double)(duration_cast<nanoseconds>(end - start).count()) / kBatchRuns;
+
+                // approximating CPU clock as 4 GHz
+                printf("%s %zu packets, 64-%zu B: %7.1f MB/s | %.2f bits/cycle\n", batched ? "crc32c_batch()," : "\ncrc32c() each, ",
+                    kPackets, maxLen, totalBytes / ns * 1e3, 2 * totalBytes / ns);
+            }
+
+            const size_t numMismatches = crc32c_batch_verify(ptrs, lens, expected, mismatches, kPackets);
+            printf("crc32c_batch_verify(): %zu mismatches\n", numMismatches);
+        }
+
+        // the same packets as CRC-32/IEEE, which has no crc32 instruction:
+        // Option 10 one at a time, then 8 at a time in AVX2 lanes. the
+        // gather version is a negative result, not an Option (see
+        // gather_methods.cpp); it's only here to show it and check it.
+        for (const bool gathered : { false, true })
+        {
+            if (gathered && !cpu.m_avx2)
+            {
+                printf("AVX2 gather: not supported on this CPU\n");
+                continue;
+            }
+
+            auto start = high_resolution_clock::now();
+            for (size_t r = 0; r < kBatchRuns / 10; ++r)
+            {
+                if (gathered)
+                    gather_batch_ieee(ptrs, lens, crcs, kPackets);
+                else
+                    option_10_batch_ieee(ptrs, lens, expected, kPackets);
+            }
+            auto end = high_resolution_clock::now();
+            const double ns = (double)(duration_cast<nanoseconds>(end - start).count()) / (kBatchRuns / 10);
+
+            const bool ok = !gathered || memcmp(crcs, expected, kPackets * sizeof(uint32_t)) == 0;
+
+            // approximating CPU clock as 4 GHz
+            printf("%s %zu IEEE packets: %7.1f MB/s | %.2f bits/cycle%s\n", gathered ? "AVX2 gather, ref   " : "Option 10, each    ",
+                kPackets, totalBytes / ns * 1e3, 2 * totalBytes / ns, ok ? "" : " MISMATCH");
+        }
+
+        delete[] mismatches;
+        delete[] expected;
+        delete[] crcs;
+        delete[] lens;
+        delete[] ptrs;
+    }
+
+    // streaming: M fed through Crc32cStream in pieces of 1-64 bytes
+    {
+        uint32_t pieces[256];
+        for (uint32_t& piece : pieces)
+            piece = 1 + dis(gen) % 64;
+
+        constexpr size_t kStreamRuns = 200;
+        uint32_t result = 0;
+        auto start = high_resolution_clock::now();
+        for (size_t i = 0; i < kStreamRuns; ++i)
+        {
+            Crc32cStream stream;
+            for (size_t pos = 0, k = 0; pos < kBytes; ++k)
+            {
+                const size_t piece = std::min((size_t)pieces[k & 255], kBytes - pos);
+                stream.Update(M + pos, piece);
+                pos += piece;
+            }
+            result = stream.Finalize();
+        }
+        auto end = high_resolution_clock::now();
+        const double ns = (double)(duration_cast<nanoseconds>(end - start).count()) / kStreamRuns;
+
+        const bool ok = result == ~crc32c(M, kBytes, 0xFFFFFFFFU);
+        printf("\nCrc32cStream, 1-64 byte updates: 0x%08x%s | %7.1f MB/s\n", result, ok ? "" : " MISMATCH", kBytes / ns * 1e3);
+    }
+
+    // thread scaling: a buffer well past any LLC, so it shows where memory
+    // bandwidth runs out
+    {
+        constexpr size_t kBigBytes = (size_t)256 * 1024 * 1024;
+        uint8_t* big = new uint8_t[kBigBytes];
+        for (size_t i = 0; i < kBigBytes; i += kBytes)
+            memcpy(big + i, M, std::min(kBytes, kBigBytes - i));
+
+        const uint32_t serial = crc32c(big, kBigBytes);
+        const uint32_t maxThreads = std::max(1U, std::thread::hardware_concurrency());
+        printf("\ncrc32c_parallel() on %zu MiB:\n", kBigBytes >> 20);
+        for (uint32_t t = 1;; t *= 2)
+        {
+            const uint32_t threads = std::min(t, maxThreads);
+            constexpr size_t kParallelRuns = 8;
+            uint32_t result = 0;
+            auto start = high_resolution_clock::now();
+            for (size_t i = 0; i < kParallelRuns; ++i)
+                result = crc32c_parallel(big, kBigBytes, 0, threads);
+            auto end = high_resolution_clock::now();
+            const double ns = (double)(duration_cast<nanoseconds>(end - start).count()) / kParallelRuns;
+
+            printf(" %3u thread%s | 0x%08x%s | %7.1f MB/s\n", threads, threads == 1 ? " " : "s", result,
+                result == serial ? "" : " MISMATCH", kBigBytes / ns * 1e3);
+
+            if (threads == maxThreads)
+                break;
+        }
+
+        delete[] big;
+    }
+
+    // one call over a buffer past 4 GiB, which the kernels now take whole.
+    // each result is checked against Option 12 run over the same buffer in
+    // 1 GiB pieces, which is how it had to be done with 32-bit lengths.
+    if (kHasHardware)
+    {
+        constexpr size_t kHugeBytes = ((size_t)4 << 30) + ((size_t)1 << 20);
+        constexpr size_t kPieceBytes = (size_t)1 << 30;
+        uint8_t* huge = new (std::nothrow) uint8_t[kHugeBytes];
+        if (!huge)
+        {
+            printf("\nSingle call on %zu MiB: couldn't allocate, skipped\n", kHugeBytes >> 20);
+        }
+        else
+        {
+            for (size_t i = 0; i < kHugeBytes; i += kBytes)
+                memcpy(huge + i, M, std::min(kBytes, kHugeBytes - i));
+
+            uint32_t reference = 0;
+            for (size_t i = 0; i < kHugeBytes; i += kPieceBytes)
+                reference = crc32c_hardware(huge + i, std::min(kPieceBytes, kHugeBytes - i), reference);
+
+            typedef uint32_t(*Kernel)(const void*, size_t, uint32_t);
+            struct HugeItem
+            {
+                const char* m_name;
+                Kernel m_f;
+                bool m_supported;
+            };
+
+            const HugeItem items[] = {
+                { "Option 12: Hardware - 8 bytes ", crc32c_hardware, kHasHardware },
+                { "Option 14: Golden   - AMD     ", option_14_golden_amd, kHasGolden },
+                { "Option 13: Golden   - Intel   ", option_13_golden_intel, kHasGolden },
+#if HAS_SYSV_GOLDEN
+                { "Option 14: Golden asm - AMD   ", option_14_golden_amd_asm, kHasGolden },
+                { "Option 13: Golden asm - Intel ", option_13_golden_intel_asm, kHasGolden },
+#endif
+                { "Option 15: Golden   - AVX-512 ", option_15_golden_avx512, kHasAvx512 },
+                { "Option 17: Golden   - Fusion  ", option_17_golden_fusion, kHasGolden },
+                { "crc32c():  Dispatch           ", crc32c_dispatch, true },
+            };
+
+            printf("\nSingle call on %zu MiB (reference 0x%08x):\n", kHugeBytes >> 20, reference);
+            for (const HugeItem& item : items)
+            {
+                if (!item.m_supported)
+                    continue;
+
+                auto start = high_resolution_clock::now();
+                const uint32_t result = item.m_f(huge, kHugeBytes, 0);
+                auto end = high_resolution_clock::now();
+                const double ns = (double)(duration_cast<nanoseconds>(end - start).count());
+
+                printf(" %s | 0x%08x%s | %7.1f MB/s\n", item.m_name, result,
+                    result == reference ? "" : " MISMATCH", kHugeBytes / ns * 1e3);
+            }
+
+            delete[] huge;
+        }
     }
 
-    printf("--------------------------------|------------|---------------------------------\n");
     printf("\nDone.\n\n");
 
     delete[] M;
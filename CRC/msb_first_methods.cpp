@@ -0,0 +1,162 @@
+#include <cstdint>
+#include <immintrin.h>
+
+#include "cpu_features.h"
+#include "crc32_msb.h"
+#include "crc32c_gf2.h"
+#include "folding_methods.h"
+#include "msb_first_methods.h"
+
+static constexpr uint32_t P_MPEG2 = 0x04c11db7U;
+
+MsbFoldingConstants compute_msb_folding_constants(uint32_t width, uint32_t poly)
+{
+    MsbFoldingConstants K;
+    K.shift = 32 - width;
+    const uint32_t P = poly << K.shift;
+
+    // carrying a 128-bit lane forward by d bits. in normal bit order the
+    // clmul product needs no correction: the high qword is multiplied by
+    // x^(d+64) and the low qword by x^d.
+    K.k512[0] = gf2_xpow_msb(512, P);
+    K.k512[1] = gf2_xpow_msb(512 + 64, P);
+    K.k128[0] = gf2_xpow_msb(128, P);
+    K.k128[1] = gf2_xpow_msb(128 + 64, P);
+
+    // for narrowing the final 128 bits (times x^32) down to 64
+    K.k96 = gf2_xpow_msb(96, P);
+    K.k64 = gf2_xpow_msb(64, P);
+
+    // Barrett constants. mu = x^64 / P, by long division.
+    const uint64_t Pn = (1ULL << 32) | P;
+    uint64_t rem = 0, mu = 0;
+    for (int32_t i = 64; i >= 0; --i)
+    {
+        rem = (rem << 1) | (i == 64);
+        if (rem >> 32)
+        {
+            mu |= 1ULL << i;
+            rem ^= Pn;
+        }
+    }
+    K.mu = mu;
+    K.poly = P;
+
+    // 1-byte tabular, for the final few bytes
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t R = i << 24;
+        for (uint32_t j = 0; j < 8; ++j)
+        {
+            R = R & 0x80000000U ? (R << 1) ^ P : R << 1;
+        }
+        K.tbl[i] = R;
+    }
+    return K;
+}
+
+// the top-aligned CRC of 128 bits of message data, with a zero CRC coming in
+CRC_TARGET_CLMUL static inline uint32_t reduce_128(__m128i vX, const MsbFoldingConstants& K)
+{
+    // X * x^32 = hi * x^96 + lo * x^32 -> 96 bits
+    __m128i vT = _mm_clmulepi64_si128(vX, _mm_cvtsi64_si128(K.k96), 0x01);
+    vT = _mm_xor_si128(vT, _mm_slli_si128(_mm_move_epi64(vX), 4));
+
+    // 96 -> 64: fold the top 32 bits by x^64
+    const uint64_t U = (uint64_t)_mm_cvtsi128_si64(_mm_xor_si128(_mm_clmulepi64_si128(vT, _mm_cvtsi64_si128(K.k64), 0x01), vT));
+
+    // Barrett reduction: q = (U / x^32) * mu / x^32, R = U ^ q * P
+    const __m128i vQ = _mm_clmulepi64_si128(_mm_cvtsi64_si128(U >> 32), _mm_cvtsi64_si128(K.mu), 0x00);
+    const __m128i vQP = _mm_clmulepi64_si128(_mm_srli_epi64(vQ, 32), _mm_cvtsi64_si128(K.poly), 0x00);
+    return (uint32_t)U ^ (uint32_t)_mm_cvtsi128_si32(vQP);
+}
+
+CRC_TARGET_CLMUL uint32_t crc_msb_folding(const void* M, size_t bytes, const MsbFoldingConstants& K, uint32_t prev)
+{
+    const uint8_t* pM = (const uint8_t*)M;
+    uint32_t R = prev << K.shift;
+
+    if (bytes >= 16)
+    {
+        const __m128i vReverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+        // prev is injected by xoring it into the first 32 bits of the message,
+        // which are now the top 32 bits of the lane
+        __m128i vX = _mm_xor_si128(load_reversed(pM, vReverse), _mm_slli_si128(_mm_cvtsi32_si128(R), 12));
+        pM += 16;
+        bytes -= 16;
+
+        const __m128i vK128 = _mm_loadu_si128((const __m128i*)K.k128);
+
+        if (bytes >= 48)
+        {
+            __m128i v1 = load_reversed(pM + 0, vReverse);
+            __m128i v2 = load_reversed(pM + 16, vReverse);
+            __m128i v3 = load_reversed(pM + 32, vReverse);
+            pM += 48;
+            bytes -= 48;
+
+            const __m128i vK512 = _mm_loadu_si128((const __m128i*)K.k512);
+            for (; bytes >= 64; bytes -= 64, pM += 64)
+            {
+                vX = fold_128(vX, vK512, load_reversed(pM + 0, vReverse));
+                v1 = fold_128(v1, vK512, load_reversed(pM + 16, vReverse));
+                v2 = fold_128(v2, vK512, load_reversed(pM + 32, vReverse));
+                v3 = fold_128(v3, vK512, load_reversed(pM + 48, vReverse));
+            }
+
+            vX = fold_128(vX, vK128, v1);
+            vX = fold_128(vX, vK128, v2);
+            vX = fold_128(vX, vK128, v3);
+        }
+
+        for (; bytes >= 16; bytes -= 16, pM += 16)
+            vX = fold_128(vX, vK128, load_reversed(pM, vReverse));
+
+        R = reduce_128(vX, K);
+    }
+
+    for (; bytes; --bytes, ++pM)
+        R = (R << 8) ^ K.tbl[(R >> 24) ^ *pM];
+
+    return R >> K.shift;
+}
+
+static const MsbFoldingConstants& mpeg2_constants()
+{
+    static const MsbFoldingConstants K = compute_msb_folding_constants(32, P_MPEG2);
+    return K;
+}
+
+// OPTION 22 and 23 for the full 32-bit width, with a zero init like the
+// other benchmarked kernels
+uint32_t option_5_naive_mpeg2(const void* M, size_t bytes)
+{
+    return msb_naive<32, P_MPEG2>(M, bytes);
+}
+
+uint32_t option_22_mpeg2_8_bytes(const void* M, size_t bytes)
+{
+    return msb_tabular_8_bytes<32, P_MPEG2>(M, bytes);
+}
+
+uint32_t option_22_mpeg2_16_bytes(const void* M, size_t bytes)
+{
+    return msb_tabular_16_bytes<32, P_MPEG2>(M, bytes);
+}
+
+uint32_t option_23_mpeg2_folding(const void* M, size_t bytes)
+{
+    return crc_msb_folding(M, bytes, mpeg2_constants(), 0);
+}
+
+uint32_t crc32_mpeg2(const void* M, size_t bytes, uint32_t prev/* = 0xFFFFFFFFU*/)
+{
+    const bool hasPclmul = get_cpu_features().m_pclmul;
+    return hasPclmul && bytes >= 16 ? crc_msb_folding(M, bytes, mpeg2_constants(), prev) : msb_tabular_8_bytes<32, P_MPEG2>(M, bytes, prev);
+}
+
+uint32_t crc32_bzip2(const void* M, size_t bytes, uint32_t prev/* = 0*/)
+{
+    return ~crc32_mpeg2(M, bytes, ~prev);
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "cpu_features.h"
+
+// MSB-first (non-reflected) CRCs of any width up to 32. the W-bit CRC is
+// kept top-aligned in a 32-bit R, which is the same as running a 32-bit
+// CRC with the poly multiplied by x^(32-W): R ends up holding the W-bit
+// CRC shifted up by 32-W. Poly is in normal bit order without its x^W
+// term, e.g. 0x8BB7 for CRC-16/T10-DIF.
+
+static inline uint32_t load_be32(const uint8_t* p)
+{
+    uint32_t x;
+    memcpy(&x, p, 4);
+#ifdef _MSC_VER
+    return _byteswap_ulong(x);
+#else
+    return __builtin_bswap32(x);
+#endif
+}
+
+static inline uint64_t load_be64(const uint8_t* p)
+{
+    uint64_t x;
+    memcpy(&x, p, 8);
+#ifdef _MSC_VER
+    return _byteswap_uint64(x);
+#else
+    return __builtin_bswap64(x);
+#endif
+}
+
+template <uint32_t Width, uint32_t Poly>
+struct MsbPoly
+{
+    static_assert(Width >= 8 && Width <= 32, "MSB-first kernels handle 8- to 32-bit CRCs");
+    static constexpr uint32_t kShift = 32 - Width;
+    static constexpr uint32_t kAligned = Poly << kShift;
+};
+
+template <uint32_t Width, uint32_t Poly>
+uint32_t msb_naive(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    typedef MsbPoly<Width, Poly> P;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev << P::kShift;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        R ^= (uint32_t)M8[i] << 24;
+        for (uint32_t j = 0; j < 8; ++j)
+        {
+            R = R & 0x80000000U ? (R << 1) ^ P::kAligned : R << 1;
+        }
+    }
+    return R >> P::kShift;
+}
+
+// table k holds the top-aligned CRC of byte i followed by k zero bytes
+template <uint32_t Width, uint32_t Poly, uint32_t Slices>
+struct MsbTables
+{
+    alignas(64) uint32_t m_tbl[256 * Slices];
+};
+
+template <uint32_t Width, uint32_t Poly, uint32_t Slices>
+constexpr MsbTables<Width, Poly, Slices> make_msb_tables()
+{
+    MsbTables<Width, Poly, Slices> t = {};
+    uint32_t i = 0;
+
+    for (; i < 256; ++i)
+    {
+        uint32_t R = i << 24;
+        for (int j = 0; j < 8; ++j)
+        {
+            R = R & 0x80000000U ? (R << 1) ^ MsbPoly<Width, Poly>::kAligned : R << 1;
+        }
+        t.m_tbl[i] = R;
+    }
+
+    for (; i < Slices * 256; ++i)
+    {
+        const uint32_t R = t.m_tbl[i - 256];
+        t.m_tbl[i] = (R << 8) ^ t.m_tbl[R >> 24];
+    }
+
+    return t;
+}
+
+template <uint32_t Width, uint32_t Poly, uint32_t Slices>
+struct MsbTablesFor
+{
+    static constexpr MsbTables<Width, Poly, Slices> kTables = make_msb_tables<Width, Poly, Slices>();
+};
+
+template <uint32_t Width, uint32_t Poly, uint32_t Slices>
+constexpr MsbTables<Width, Poly, Slices> MsbTablesFor<Width, Poly, Slices>::kTables;
+
+// the same slicing as the reflected Options 6, 9 and 10, with the bytes
+// of each word taken from the top of R down.
+
+#define T(k, x) tbl[(k) * 256 + uint8_t(x)]
+
+template <uint32_t Width, uint32_t Poly>
+uint32_t msb_tabular_1_byte(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    typedef MsbPoly<Width, Poly> P;
+    const uint32_t* tbl = MsbTablesFor<Width, Poly, 1>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev << P::kShift;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        R = (R << 8) ^ tbl[(R >> 24) ^ M8[i]];
+    }
+    return R >> P::kShift;
+}
+
+template <uint32_t Width, uint32_t Poly>
+uint32_t msb_tabular_8_bytes(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    typedef MsbPoly<Width, Poly> P;
+    const uint32_t* tbl = MsbTablesFor<Width, Poly, 8>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev << P::kShift;
+    for (; bytes >= 8; bytes -= 8, M8 += 8)
+    {
+        R ^= load_be32(M8);
+        const uint32_t R2 = load_be32(M8 + 4);
+        R = T(7, R  >> 24) ^ T(6, R  >> 16) ^ T(5, R  >> 8) ^ T(4, R  >> 0) ^
+            T(3, R2 >> 24) ^ T(2, R2 >> 16) ^ T(1, R2 >> 8) ^ T(0, R2 >> 0);
+    }
+
+    for (; bytes; --bytes, ++M8)
+        R = (R << 8) ^ tbl[(R >> 24) ^ *M8];
+
+    return R >> P::kShift;
+}
+
+template <uint32_t Width, uint32_t Poly>
+uint32_t msb_tabular_16_bytes(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    typedef MsbPoly<Width, Poly> P;
+    const uint32_t* tbl = MsbTablesFor<Width, Poly, 16>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev << P::kShift;
+    for (; bytes >= 16; bytes -= 16, M8 += 16)
+    {
+        R ^= load_be32(M8);
+        const uint32_t R2 = load_be32(M8 + 4);
+        const uint32_t R3 = load_be32(M8 + 8);
+        const uint32_t R4 = load_be32(M8 + 12);
+        R = T(15, R  >> 24) ^ T(14, R  >> 16) ^ T(13, R  >> 8) ^ T(12, R  >> 0) ^
+            T(11, R2 >> 24) ^ T(10, R2 >> 16) ^ T( 9, R2 >> 8) ^ T( 8, R2 >> 0) ^
+            T( 7, R3 >> 24) ^ T( 6, R3 >> 16) ^ T( 5, R3 >> 8) ^ T( 4, R3 >> 0) ^
+            T( 3, R4 >> 24) ^ T( 2, R4 >> 16) ^ T( 1, R4 >> 8) ^ T( 0, R4 >> 0);
+    }
+
+    for (; bytes; --bytes, ++M8)
+        R = (R << 8) ^ tbl[(R >> 24) ^ *M8];
+
+    return R >> P::kShift;
+}
+
+#undef T
+
+// loads 16 message bytes as one 128-bit polynomial: the first byte's MSB
+// becomes bit 127, the highest power
+CRC_TARGET_CLMUL static inline __m128i load_reversed(const uint8_t* p, __m128i vReverse)
+{
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)p), vReverse);
+}
+
+// PCLMULQDQ folding for any MSB-first poly of width 8 to 32, with the
+// constants generated at runtime like Option 16's
+struct MsbFoldingConstants
+{
+    uint64_t k512[2];
+    uint64_t k128[2];
+    uint64_t k96;
+    uint64_t k64;
+    uint64_t mu;
+    uint64_t poly;
+    uint32_t shift;
+    uint32_t tbl[256];
+};
+
+MsbFoldingConstants compute_msb_folding_constants(uint32_t width, uint32_t poly);
+uint32_t crc_msb_folding(const void* M, size_t bytes, const MsbFoldingConstants& K, uint32_t prev);
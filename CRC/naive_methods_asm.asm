@@ -3,13 +3,13 @@
 ; this poly CAN be changed to any desired 32-bit CRC poly.
 P equ 082f63b78h
 
-; uint32_t f(const void* M, uint32_t bytes);
+; uint32_t f(const void* M, size_t bytes);
 
 ;; OPTION 1
 option_1_cf_jump PROC
 xor eax, eax
 
-test edx, edx
+test rdx, rdx
 jz END_OF_LOOP
 
 add rcx, rdx
@@ -36,7 +36,7 @@ option_1_cf_jump ENDP
 option_2_multiply_mask PROC
 xor eax, eax
 
-test edx, edx
+test rdx, rdx
 jz END_OF_LOOP
 
 add rcx, rdx
@@ -65,7 +65,7 @@ option_2_multiply_mask ENDP
 option_3_bit_mask PROC
 xor eax, eax
 
-test edx, edx
+test rdx, rdx
 jz END_OF_LOOP
 
 add rcx, rdx
@@ -94,7 +94,7 @@ option_3_bit_mask ENDP
 option_4_cmove PROC
 xor eax, eax
 
-test edx, edx
+test rdx, rdx
 jz END_OF_LOOP
 
 add rcx, rdx
@@ -0,0 +1,94 @@
+#include <cstdint>
+
+#include "cpu_features.h"
+#include "crc_narrow.h"
+#include "folding_methods.h"
+#include "msb_first_methods.h"
+#include "tabular_methods.h"
+
+// T10-DIF and SMBUS are MSB-first and run on the top-aligned kernels in
+// msb_first_methods.h. CCITT is reflected, and a reflected W-bit CRC is
+// just a 32-bit one whose poly has no terms above x^(W-1), so it runs
+// unchanged on the tabular and folding kernels of Options 10 and 16.
+static constexpr uint32_t P_T10DIF = 0x8bb7U;  // normal, width 16
+static constexpr uint32_t P_SMBUS = 0x07U;     // normal, width 8
+static constexpr uint32_t P_CCITT = 0x8408U;   // reflected, width 16
+
+static const MsbFoldingConstants& t10dif_constants()
+{
+    static const MsbFoldingConstants K = compute_msb_folding_constants(16, P_T10DIF);
+    return K;
+}
+
+static const MsbFoldingConstants& smbus_constants()
+{
+    static const MsbFoldingConstants K = compute_msb_folding_constants(8, P_SMBUS);
+    return K;
+}
+
+static const FoldingConstants& ccitt_constants()
+{
+    static const FoldingConstants K = compute_folding_constants(P_CCITT);
+    return K;
+}
+
+// OPTION 22
+uint32_t option_22_t10dif_1_byte(const void* M, size_t bytes)
+{
+    return msb_tabular_1_byte<16, P_T10DIF>(M, bytes);
+}
+
+uint32_t option_22_t10dif_8_bytes(const void* M, size_t bytes)
+{
+    return msb_tabular_8_bytes<16, P_T10DIF>(M, bytes);
+}
+
+uint32_t option_22_t10dif_16_bytes(const void* M, size_t bytes)
+{
+    return msb_tabular_16_bytes<16, P_T10DIF>(M, bytes);
+}
+
+uint32_t option_22_smbus_16_bytes(const void* M, size_t bytes)
+{
+    return msb_tabular_16_bytes<8, P_SMBUS>(M, bytes);
+}
+
+// OPTION 23
+uint32_t option_23_t10dif_folding(const void* M, size_t bytes)
+{
+    return crc_msb_folding(M, bytes, t10dif_constants(), 0);
+}
+
+uint32_t option_23_smbus_folding(const void* M, size_t bytes)
+{
+    return crc_msb_folding(M, bytes, smbus_constants(), 0);
+}
+
+// CCITT on the reflected kernels
+uint32_t option_10_tabular_16_bytes_ccitt(const void* M, size_t bytes)
+{
+    return tabular_16_bytes<P_CCITT>(M, bytes);
+}
+
+uint32_t option_16_folding_ccitt(const void* M, size_t bytes)
+{
+    return crc32_folding(M, bytes, ccitt_constants(), 0);
+}
+
+uint16_t crc16_t10dif(const void* M, size_t bytes, uint16_t prev/* = 0*/)
+{
+    const bool hasPclmul = get_cpu_features().m_pclmul;
+    return (uint16_t)(hasPclmul && bytes >= 16 ? crc_msb_folding(M, bytes, t10dif_constants(), prev) : msb_tabular_16_bytes<16, P_T10DIF>(M, bytes, prev));
+}
+
+uint8_t crc8_smbus(const void* M, size_t bytes, uint8_t prev/* = 0*/)
+{
+    const bool hasPclmul = get_cpu_features().m_pclmul;
+    return (uint8_t)(hasPclmul && bytes >= 16 ? crc_msb_folding(M, bytes, smbus_constants(), prev) : msb_tabular_16_bytes<8, P_SMBUS>(M, bytes, prev));
+}
+
+uint16_t crc16_ccitt(const void* M, size_t bytes, uint16_t prev/* = 0*/)
+{
+    const bool hasPclmul = get_cpu_features().m_pclmul;
+    return (uint16_t)(hasPclmul && bytes >= 16 ? crc32_folding(M, bytes, ccitt_constants(), prev) : tabular_16_bytes<P_CCITT>(M, bytes, prev));
+}
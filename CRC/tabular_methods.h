@@ -0,0 +1,618 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "crc32c_gf2.h"
+
+// the tables for the tabular methods, built at compile time for any
+// reflected 32-bit poly. table k holds CRC(i) followed by k zero bytes,
+// so m_tbl[k * 256 + i] is exactly what compute_tabular_method_tables()
+// produces at runtime.
+template <uint32_t Poly, uint32_t Slices>
+struct TabularTables
+{
+    alignas(64) uint32_t m_tbl[256 * Slices];
+};
+
+template <uint32_t Poly, uint32_t Slices>
+constexpr TabularTables<Poly, Slices> make_tabular_tables()
+{
+    TabularTables<Poly, Slices> t = {};
+    uint32_t i = 0;
+
+    for (; i < 256; ++i)
+    {
+        uint32_t R = i;
+        for (int j = 0; j < 8; ++j)
+        {
+            R = R & 1 ? (R >> 1) ^ Poly : R >> 1;
+        }
+        t.m_tbl[i] = R;
+    }
+
+    for (; i < Slices * 256; ++i)
+    {
+        const uint32_t R = t.m_tbl[i - 256];
+        t.m_tbl[i] = (R >> 8) ^ t.m_tbl[uint8_t(R)];
+    }
+
+    return t;
+}
+
+// one instance of the tables per poly and slice count, shared by every
+// kernel instantiated with them
+template <uint32_t Poly, uint32_t Slices>
+struct TabularTablesFor
+{
+    static constexpr TabularTables<Poly, Slices> kTables = make_tabular_tables<Poly, Slices>();
+};
+
+template <uint32_t Poly, uint32_t Slices>
+constexpr TabularTables<Poly, Slices> TabularTablesFor<Poly, Slices>::kTables;
+
+// the same with 4-bit indices: table k holds CRC(i) for a nibble i
+// followed by k zero nibbles. each table is 64 bytes, one cache line.
+template <uint32_t Poly, uint32_t Nibbles>
+struct NibbleTables
+{
+    alignas(64) uint32_t m_tbl[16 * Nibbles];
+};
+
+template <uint32_t Poly, uint32_t Nibbles>
+constexpr NibbleTables<Poly, Nibbles> make_nibble_tables()
+{
+    NibbleTables<Poly, Nibbles> t = {};
+    uint32_t i = 0;
+
+    for (; i < 16; ++i)
+    {
+        uint32_t R = i;
+        for (int j = 0; j < 4; ++j)
+        {
+            R = R & 1 ? (R >> 1) ^ Poly : R >> 1;
+        }
+        t.m_tbl[i] = R;
+    }
+
+    for (; i < Nibbles * 16; ++i)
+    {
+        const uint32_t R = t.m_tbl[i - 16];
+        t.m_tbl[i] = (R >> 4) ^ t.m_tbl[R & 15];
+    }
+
+    return t;
+}
+
+template <uint32_t Poly, uint32_t Nibbles>
+struct NibbleTablesFor
+{
+    static constexpr NibbleTables<Poly, Nibbles> kTables = make_nibble_tables<Poly, Nibbles>();
+};
+
+template <uint32_t Poly, uint32_t Nibbles>
+constexpr NibbleTables<Poly, Nibbles> NibbleTablesFor<Poly, Nibbles>::kTables;
+
+// the bodies of Options 6-10, for any poly. Options 7-10 take any length
+// and alignment: they finish a few bytes at a time until their loads are
+// aligned, then pick up the tail with one final load that ends at the
+// end of the buffer, overlapping bytes already done.
+
+// the heads and tails: CRC(R, t) for a t of r bytes shorter than a block
+// is what's left of a block step when t is moved to the end of the block,
+// behind zeros, and R is folded in right where t starts. the zeros index
+// table entry 0, which is 0, and the bytes of R that land past the block
+// are the R >> 8r a byte-at-a-time loop would have left. every lookup is
+// independent, where a byte loop would be r of them back to back.
+
+static inline uint32_t tabular_bytes(const uint32_t* tbl, uint32_t R, const uint8_t* M8, size_t bytes)
+{
+    for (; bytes; --bytes, ++M8)
+        R = (R >> 8) ^ tbl[(R ^ *M8) & 0xFF];
+    return R;
+}
+
+// the first 1-3 bytes at M8, out of at least 4
+static inline uint32_t tabular_head_4(const uint32_t* tbl, uint32_t R, const uint8_t* M8, uint32_t h)
+{
+    uint32_t W;
+    memcpy(&W, M8, 4);
+    const uint32_t Y = (R ^ W) << (32 - 8 * h);
+    return (R >> (8 * h)) ^
+        tbl[0 * 256 + uint8_t(Y >> 24)] ^
+        tbl[1 * 256 + uint8_t(Y >> 16)] ^
+        tbl[2 * 256 + uint8_t(Y >> 8)] ^
+        tbl[3 * 256 + uint8_t(Y >> 0)];
+}
+
+// the last 1-3 bytes before pEnd, out of at least 4
+static inline uint32_t tabular_tail_4(const uint32_t* tbl, uint32_t R, const uint8_t* pEnd, uint32_t r)
+{
+    uint32_t W;
+    memcpy(&W, pEnd - 4, 4);
+    const uint32_t z = 32 - 8 * r;
+    const uint32_t Y = ((W >> z) ^ R) << z;
+    return (R >> (8 * r)) ^
+        tbl[0 * 256 + uint8_t(Y >> 24)] ^
+        tbl[1 * 256 + uint8_t(Y >> 16)] ^
+        tbl[2 * 256 + uint8_t(Y >> 8)] ^
+        tbl[3 * 256 + uint8_t(Y >> 0)];
+}
+
+// the last 1-8 bytes before pEnd, out of at least 8. from 4 bytes up, all
+// of R lands inside the block; shifting it out would be a shift by 32 or
+// more, which C++ leaves undefined.
+static inline uint32_t tabular_tail_8(const uint32_t* tbl, uint32_t R, const uint8_t* pEnd, uint32_t r)
+{
+    uint64_t W;
+    memcpy(&W, pEnd - 8, 8);
+    const uint32_t z = 64 - 8 * r;
+    const uint64_t Y = ((W >> z) ^ R) << z;
+    return (r < 4 ? R >> (8 * r) : 0) ^
+        tbl[0 * 256 + uint8_t(Y >> 56)] ^
+        tbl[1 * 256 + uint8_t(Y >> 48)] ^
+        tbl[2 * 256 + uint8_t(Y >> 40)] ^
+        tbl[3 * 256 + uint8_t(Y >> 32)] ^
+        tbl[4 * 256 + uint8_t(Y >> 24)] ^
+        tbl[5 * 256 + uint8_t(Y >> 16)] ^
+        tbl[6 * 256 + uint8_t(Y >> 8)] ^
+        tbl[7 * 256 + uint8_t(Y >> 0)];
+}
+
+// the bytes up to the next multiple of 4, so the main loop's loads are
+// aligned. needs at least 4 bytes.
+static inline const uint8_t* tabular_align_4(const uint32_t* tbl, uint32_t* pR, const uint8_t* M8, size_t* pBytes)
+{
+    const uint32_t h = (uint32_t)(0 - (uintptr_t)M8) & 3;
+    if (h)
+    {
+        *pR = tabular_head_4(tbl, *pR, M8, h);
+        *pBytes -= h;
+    }
+    return M8 + h;
+}
+
+template <uint32_t Poly>
+uint32_t tabular_1_byte(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    const uint32_t* tbl = TabularTablesFor<Poly, 1>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        R = (R >> 8) ^ tbl[(R ^ M8[i]) & 0xFF];
+    }
+    return R;
+}
+
+template <uint32_t Poly>
+uint32_t tabular_2_bytes(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    const uint32_t* tbl = TabularTablesFor<Poly, 2>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev;
+
+    // a head or tail is at most one byte
+    if (((uintptr_t)M8 & 1) && bytes)
+    {
+        R = tabular_bytes(tbl, R, M8++, 1);
+        --bytes;
+    }
+
+    const uint16_t* M16 = (const uint16_t*)M8;
+    for (size_t i = 0; i < bytes >> 1; ++i)
+    {
+        R ^= M16[i];
+        R = (R >> 16) ^
+            tbl[0 * 256 + uint8_t(R >> 8)] ^
+            tbl[1 * 256 + uint8_t(R >> 0)];
+    }
+
+    return tabular_bytes(tbl, R, M8 + (bytes & ~(size_t)1), bytes & 1);
+}
+
+template <uint32_t Poly>
+uint32_t tabular_4_bytes(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    const uint32_t* tbl = TabularTablesFor<Poly, 4>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev;
+    if (bytes < 4)
+        return tabular_bytes(tbl, R, M8, bytes);
+
+    M8 = tabular_align_4(tbl, &R, M8, &bytes);
+    const uint32_t* M32 = (const uint32_t*)M8;
+    for (size_t i = 0; i < bytes >> 2; ++i)
+    {
+        R ^= M32[i];
+        R = tbl[0 * 256 + uint8_t(R >> 24)] ^
+            tbl[1 * 256 + uint8_t(R >> 16)] ^
+            tbl[2 * 256 + uint8_t(R >>  8)] ^
+            tbl[3 * 256 + uint8_t(R >>  0)];
+    }
+
+    if (bytes & 3)
+        R = tabular_tail_4(tbl, R, M8 + bytes, bytes & 3);
+    return R;
+}
+
+template <uint32_t Poly>
+uint32_t tabular_8_bytes(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    const uint32_t* tbl = TabularTablesFor<Poly, 8>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev;
+    if (bytes < 8)
+        return tabular_bytes(tbl, R, M8, bytes);
+
+    M8 = tabular_align_4(tbl, &R, M8, &bytes);
+    const uint32_t* M32 = (const uint32_t*)M8;
+    for (; bytes >= 8; bytes -= 8)
+    {
+        R ^= *M32++;
+        const uint32_t R2 = *M32++;
+        R = tbl[0 * 256 + uint8_t(R2 >> 24)] ^
+            tbl[1 * 256 + uint8_t(R2 >> 16)] ^
+            tbl[2 * 256 + uint8_t(R2 >> 8 )] ^
+            tbl[3 * 256 + uint8_t(R2 >> 0 )] ^
+            tbl[4 * 256 + uint8_t(R  >> 24)] ^
+            tbl[5 * 256 + uint8_t(R  >> 16)] ^
+            tbl[6 * 256 + uint8_t(R  >> 8 )] ^
+            tbl[7 * 256 + uint8_t(R  >> 0 )];
+    }
+
+    if (bytes)
+        R = tabular_tail_8(tbl, R, (const uint8_t*)M32 + bytes, (uint32_t)bytes);
+    return R;
+}
+
+template <uint32_t Poly>
+uint32_t tabular_16_bytes(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    const uint32_t* tbl = TabularTablesFor<Poly, 16>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev;
+    if (bytes < 8)
+        return tabular_bytes(tbl, R, M8, bytes);
+
+    M8 = tabular_align_4(tbl, &R, M8, &bytes);
+    const uint32_t* M32 = (const uint32_t*)M8;
+    for (; bytes >= 16; bytes -= 16)
+    {
+        R ^= *M32++;
+        const uint32_t R2 = *M32++;
+        const uint32_t R3 = *M32++;
+        const uint32_t R4 = *M32++;
+        R = tbl[ 0 * 256 + uint8_t(R4 >> 24)] ^
+            tbl[ 1 * 256 + uint8_t(R4 >> 16)] ^
+            tbl[ 2 * 256 + uint8_t(R4 >> 8)] ^
+            tbl[ 3 * 256 + uint8_t(R4 >> 0)] ^
+            tbl[ 4 * 256 + uint8_t(R3 >> 24)] ^
+            tbl[ 5 * 256 + uint8_t(R3 >> 16)] ^
+            tbl[ 6 * 256 + uint8_t(R3 >> 8)] ^
+            tbl[ 7 * 256 + uint8_t(R3 >> 0)] ^
+            tbl[ 8 * 256 + uint8_t(R2 >> 24)] ^
+            tbl[ 9 * 256 + uint8_t(R2 >> 16)] ^
+            tbl[10 * 256 + uint8_t(R2 >> 8)] ^
+            tbl[11 * 256 + uint8_t(R2 >> 0)] ^
+            tbl[12 * 256 + uint8_t( R >> 24)] ^
+            tbl[13 * 256 + uint8_t( R >> 16)] ^
+            tbl[14 * 256 + uint8_t( R >> 8)] ^
+            tbl[15 * 256 + uint8_t( R >> 0)];
+    }
+
+    // up to 15 left: a whole 8 if there is one, then the overlapping tail
+    const uint8_t* pEnd = (const uint8_t*)M32 + bytes;
+    if (bytes >= 8)
+        R = tabular_tail_8(tbl, R, pEnd - (bytes - 8), 8);
+    if (bytes & 7)
+        R = tabular_tail_8(tbl, R, pEnd, bytes & 7);
+    return R;
+}
+
+// the bodies of Options 25 and 26: small tables, for calls that find them
+// cold. slicing-by-16's tables are 16 KB, half of a typical L1D, and a
+// call on a small block that has to fetch them all spends most of its
+// time on misses. a nibble lookup costs as much as a byte lookup, so
+// these lose to Options 6-10 once the tables are warm.
+
+// one 64-byte table, 2 dependent lookups per byte
+template <uint32_t Poly>
+uint32_t nibble_1_byte(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    const uint32_t* tbl = NibbleTablesFor<Poly, 1>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        R ^= M8[i];
+        R = (R >> 4) ^ tbl[R & 15];
+        R = (R >> 4) ^ tbl[R & 15];
+    }
+    return R;
+}
+
+// slicing-by-4 on nibbles: 8 tables of 16, 512 bytes in all, and 8
+// independent lookups per 4 bytes
+template <uint32_t Poly>
+uint32_t nibble_4_bytes(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    const uint32_t* tbl = NibbleTablesFor<Poly, 8>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev;
+    for (; bytes >= 4; bytes -= 4, M8 += 4)
+    {
+        uint32_t W;
+        memcpy(&W, M8, 4);
+        R ^= W;
+        R = tbl[0 * 16 + (R >> 28)] ^
+            tbl[1 * 16 + ((R >> 24) & 15)] ^
+            tbl[2 * 16 + ((R >> 20) & 15)] ^
+            tbl[3 * 16 + ((R >> 16) & 15)] ^
+            tbl[4 * 16 + ((R >> 12) & 15)] ^
+            tbl[5 * 16 + ((R >> 8) & 15)] ^
+            tbl[6 * 16 + ((R >> 4) & 15)] ^
+            tbl[7 * 16 + (R & 15)];
+    }
+
+    // table 0 is the 1-nibble table
+    for (; bytes; --bytes, ++M8)
+    {
+        R ^= *M8;
+        R = (R >> 4) ^ tbl[R & 15];
+        R = (R >> 4) ^ tbl[R & 15];
+    }
+    return R;
+}
+
+// Option 6 on table 0 of Option 10's tables rather than a 1 KB table of
+// its own. a program that runs both keeps one set of lines warm, not two.
+template <uint32_t Poly>
+uint32_t tabular_shared_1_byte(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    return tabular_bytes(TabularTablesFor<Poly, 16>::kTables.m_tbl, prev, (const uint8_t*)M, bytes);
+}
+
+// the body of Option 27: Option 9 on several streams at once, joined the
+// way the golden methods join theirs. one slicing-by-8 chain spends most
+// of its time waiting on its own loads; independent chains fill that time.
+// the streams start from a zero CRC, so each one's CRC only has to be
+// carried past the streams after it and XORed in.
+//
+// that only pays where the core can issue more loads than Option 10's one
+// chain already keeps busy. both make 1.25 table and message loads per
+// byte, so on a core with 2 load ports Option 10 is already close to the
+// limit and this can come out slower; measure before choosing it (see
+// main.cpp).
+
+// a CRC followed by Bytes zero bytes, as one slicing-by-4 step: Option 8's
+// tables carried a further Bytes - 4 zero bytes. tables 4-7 of Option 9
+// are this for Bytes = 8.
+template <uint32_t Poly, uint32_t Bytes>
+struct TabularShiftTable
+{
+    alignas(64) uint32_t m_tbl[4 * 256];
+};
+
+template <uint32_t Poly, uint32_t Bytes>
+constexpr TabularShiftTable<Poly, Bytes> make_tabular_shift_table()
+{
+    static_assert(Bytes >= 4, "a shift is at least one 4-byte step");
+    TabularShiftTable<Poly, Bytes> t = {};
+    const uint32_t* tbl = TabularTablesFor<Poly, 4>::kTables.m_tbl;
+    const uint32_t K = gf2_xpow(8 * (uint64_t)(Bytes - 4), Poly);
+    for (uint32_t i = 0; i < 4 * 256; ++i)
+    {
+        t.m_tbl[i] = gf2_mulmod(tbl[i], K, Poly);
+    }
+    return t;
+}
+
+template <uint32_t Poly, uint32_t Bytes>
+struct TabularShiftTableFor
+{
+    static constexpr TabularShiftTable<Poly, Bytes> kTable = make_tabular_shift_table<Poly, Bytes>();
+};
+
+template <uint32_t Poly, uint32_t Bytes>
+constexpr TabularShiftTable<Poly, Bytes> TabularShiftTableFor<Poly, Bytes>::kTable;
+
+static inline uint32_t tabular_shift(const uint32_t* shiftTbl, uint32_t R)
+{
+    return shiftTbl[0 * 256 + uint8_t(R >> 24)] ^
+        shiftTbl[1 * 256 + uint8_t(R >> 16)] ^
+        shiftTbl[2 * 256 + uint8_t(R >> 8)] ^
+        shiftTbl[3 * 256 + uint8_t(R >> 0)];
+}
+
+// Option 9's loop body on the 8 bytes at M8
+static inline uint32_t tabular_step_8(const uint32_t* tbl, uint32_t R, const uint8_t* M8)
+{
+    uint32_t W[2];
+    memcpy(W, M8, 8);
+    R ^= W[0];
+    return tbl[0 * 256 + uint8_t(W[1] >> 24)] ^
+        tbl[1 * 256 + uint8_t(W[1] >> 16)] ^
+        tbl[2 * 256 + uint8_t(W[1] >> 8)] ^
+        tbl[3 * 256 + uint8_t(W[1] >> 0)] ^
+        tbl[4 * 256 + uint8_t(R >> 24)] ^
+        tbl[5 * 256 + uint8_t(R >> 16)] ^
+        tbl[6 * 256 + uint8_t(R >> 8)] ^
+        tbl[7 * 256 + uint8_t(R >> 0)];
+}
+
+// bytes per stream per pass. the join is Streams - 1 table shifts, a few
+// cycles each, so a pass this size hides it; anything under one full pass
+// is left to Option 10, whose tables these are.
+static constexpr uint32_t TABULAR_BRAID_BLOCK = 256;
+
+template <uint32_t Poly, uint32_t Streams>
+uint32_t tabular_braided_8_bytes(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    static_assert(Streams >= 2 && Streams <= 5, "2 to 5 streams");
+    constexpr uint32_t B = TABULAR_BRAID_BLOCK;
+    const uint32_t* tbl = TabularTablesFor<Poly, 16>::kTables.m_tbl;
+    const uint32_t* shiftTbl = TabularShiftTableFor<Poly, B>::kTable.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev;
+
+    for (; bytes >= Streams * B; bytes -= Streams * B, M8 += Streams * B)
+    {
+        // one named register per stream, as in golden_tuned()
+        uint32_t R0 = R, R1 = 0, R2 = 0, R3 = 0, R4 = 0;
+        for (uint32_t i = 0; i < B; i += 8)
+        {
+            R0 = tabular_step_8(tbl, R0, M8 + i);
+            R1 = tabular_step_8(tbl, R1, M8 + 1 * B + i);
+            if (Streams > 2)
+                R2 = tabular_step_8(tbl, R2, M8 + 2 * B + i);
+            if (Streams > 3)
+                R3 = tabular_step_8(tbl, R3, M8 + 3 * B + i);
+            if (Streams > 4)
+                R4 = tabular_step_8(tbl, R4, M8 + 4 * B + i);
+        }
+
+        R = tabular_shift(shiftTbl, R0) ^ R1;
+        if (Streams > 2)
+            R = tabular_shift(shiftTbl, R) ^ R2;
+        if (Streams > 3)
+            R = tabular_shift(shiftTbl, R) ^ R3;
+        if (Streams > 4)
+            R = tabular_shift(shiftTbl, R) ^ R4;
+    }
+
+    return tabular_16_bytes<Poly>(M8, bytes, R);
+}
+
+// slicing-by-N for any N that is a multiple of 4: the unrolled XOR tree
+// of Option 10, generated for N tables. byte b of word j of each N-byte
+// block is followed by N - 1 - (4j + b) more bytes, so that's the table
+// it indexes.
+template <uint32_t Slices, uint32_t Remaining>
+struct SliceXorTree
+{
+    static constexpr uint32_t J = Slices / 4 - Remaining;
+
+    static inline uint32_t Apply(const uint32_t* tbl, const uint32_t* W)
+    {
+        return tbl[(Slices - 1 - 4 * J) * 256 + uint8_t(W[J] >>  0)] ^
+               tbl[(Slices - 2 - 4 * J) * 256 + uint8_t(W[J] >>  8)] ^
+               tbl[(Slices - 3 - 4 * J) * 256 + uint8_t(W[J] >> 16)] ^
+               tbl[(Slices - 4 - 4 * J) * 256 + uint8_t(W[J] >> 24)] ^
+               SliceXorTree<Slices, Remaining - 1>::Apply(tbl, W);
+    }
+};
+
+template <uint32_t Slices>
+struct SliceXorTree<Slices, 0>
+{
+    static inline uint32_t Apply(const uint32_t*, const uint32_t*)
+    {
+        return 0;
+    }
+};
+
+template <uint32_t Poly, uint32_t Slices>
+uint32_t tabular_n_bytes(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    static_assert(Slices >= 4 && Slices % 4 == 0, "slice count must be a multiple of 4");
+    const uint32_t* tbl = TabularTablesFor<Poly, Slices>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev;
+    for (; bytes >= Slices; bytes -= Slices, M8 += Slices)
+    {
+        uint32_t W[Slices / 4];
+        memcpy(W, M8, Slices);
+        W[0] ^= R;
+        R = SliceXorTree<Slices, Slices / 4>::Apply(tbl, W);
+    }
+
+    for (; bytes; --bytes, ++M8)
+        R = (R >> 8) ^ tbl[(R ^ *M8) & 0xFF];
+
+    return R;
+}
+
+// the same with 16-bit indices into 64K-entry tables, halving the lookups
+// per byte. wide table k holds the CRC of a 2-byte value followed by 2k
+// zero bytes; it's 256 KiB, so these are far too big to build at compile
+// time and are built from the byte tables on first use instead.
+template <uint32_t Pairs>
+struct WideTabularTables
+{
+    alignas(64) uint32_t m_tbl[65536 * Pairs];
+};
+
+template <uint32_t Poly, uint32_t Pairs>
+struct WideTabularTablesFor
+{
+    static WideTabularTables<Pairs> s_tables;
+
+    static bool Build()
+    {
+        const uint32_t* tbl = TabularTablesFor<Poly, 2 * Pairs>::kTables.m_tbl;
+        for (uint32_t k = 0; k < Pairs; ++k)
+        {
+            for (uint32_t i = 0; i < 65536; ++i)
+            {
+                s_tables.m_tbl[k * 65536 + i] = tbl[(2 * k + 1) * 256 + (i & 0xFF)] ^ tbl[2 * k * 256 + (i >> 8)];
+            }
+        }
+        return true;
+    }
+
+    static const uint32_t* Get()
+    {
+        static const bool kBuilt = Build();
+        (void)kBuilt;
+        return s_tables.m_tbl;
+    }
+};
+
+template <uint32_t Poly, uint32_t Pairs>
+WideTabularTables<Pairs> WideTabularTablesFor<Poly, Pairs>::s_tables;
+
+template <uint32_t Pairs, uint32_t Remaining>
+struct WideSliceXorTree
+{
+    static constexpr uint32_t J = Pairs / 2 - Remaining;
+
+    static inline uint32_t Apply(const uint32_t* tbl, const uint32_t* W)
+    {
+        return tbl[(Pairs - 1 - 2 * J) * 65536 + uint16_t(W[J] >>  0)] ^
+               tbl[(Pairs - 2 - 2 * J) * 65536 + uint16_t(W[J] >> 16)] ^
+               WideSliceXorTree<Pairs, Remaining - 1>::Apply(tbl, W);
+    }
+};
+
+template <uint32_t Pairs>
+struct WideSliceXorTree<Pairs, 0>
+{
+    static inline uint32_t Apply(const uint32_t*, const uint32_t*)
+    {
+        return 0;
+    }
+};
+
+template <uint32_t Poly, uint32_t Pairs>
+uint32_t tabular_wide_n_bytes(const void* M, size_t bytes, uint32_t prev = 0)
+{
+    static_assert(Pairs >= 2 && Pairs % 2 == 0, "pair count must be a multiple of 2");
+    const uint32_t* wideTbl = WideTabularTablesFor<Poly, Pairs>::Get();
+    const uint32_t* tbl = TabularTablesFor<Poly, 1>::kTables.m_tbl;
+    const uint8_t* M8 = (const uint8_t*)M;
+    uint32_t R = prev;
+    for (; bytes >= 2 * Pairs; bytes -= 2 * Pairs, M8 += 2 * Pairs)
+    {
+        uint32_t W[Pairs / 2];
+        memcpy(W, M8, 2 * Pairs);
+        W[0] ^= R;
+        R = WideSliceXorTree<Pairs, Pairs / 2>::Apply(wideTbl, W);
+    }
+
+    for (; bytes; --bytes, ++M8)
+        R = (R >> 8) ^ tbl[(R ^ *M8) & 0xFF];
+
+    return R;
+}